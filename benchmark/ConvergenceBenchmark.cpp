@@ -0,0 +1,118 @@
+#include "../node/Node.h"
+#include "../network/LinkGraph.h"
+#include "../network/SequentialRounds.h"
+#include "../network/SynchronousRounds.h"
+#include "../topography/Topography.h"
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+// The node count and signal strength of the predefined simulations
+const vector<pair<int, int>> PRESETS = {{10, 5000}, {30, 7000}, {50, 6000}, {100, 2000}, {200, 400},
+                                        {600, 70}, {750, 70}, {30, 50}, {100, 20}};
+const int MAP_SIZE = 500;
+const int MAPS_PER_PRESET = 3;
+
+// Scatters the nodes over the map like the predefined simulations do, with the same positions for every seed
+vector<tuple<int, int, int>> scatterNodes(Topography& topography, int numberOfNodes, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> distXY(1, MAP_SIZE - 1);
+    uniform_int_distribution<int> distZ(1, 20);
+    vector<tuple<int, int, int>> positions;
+    for (int i = 0; i < numberOfNodes; i++) {
+        int x = distXY(rng);
+        int y = distXY(rng);
+        int z = distZ(rng);
+        if (topography.getHeight(x, y) > z) {
+            z += topography.getHeight(x, y) + 1;
+        }
+        positions.emplace_back(x, y, z);
+    }
+    return positions;
+}
+
+// Runs rounds on fresh nodes until a round changes no routes. Returns the number of rounds, or -1 if the tables did
+// not converge within maxRounds, and adds the time of the rounds to milliseconds.
+int roundsToConverge(Topography& topography, const vector<tuple<int, int, int>>& positions, int signalStrength,
+                     const function<int(const vector<Node*>&)>& runRound, int maxRounds, double& milliseconds) {
+    deque<Node> nodes;
+    vector<Node*> nodePointers;
+    for (const auto& [x, y, z] : positions) {
+        nodes.emplace_back(static_cast<int>(nodes.size()), x, y, z, signalStrength, &topography);
+        nodePointers.push_back(&nodes.back());
+    }
+    for (Node* node : nodePointers) {
+        node->updateAllNodes(nodePointers);
+    }
+    LinkGraph linkGraph(&topography);
+    linkGraph.build(nodePointers);
+    linkGraph.getLinkCount(); // Evaluate the links before the timing starts
+
+    auto start = chrono::steady_clock::now();
+    int rounds = 0;
+    int changes = -1;
+    while (changes != 0 && rounds < maxRounds) {
+        changes = runRound(nodePointers);
+        rounds++;
+    }
+    milliseconds += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return changes == 0 ? rounds : -1;
+}
+
+// Compares the number of broadcast rounds until the routing tables converge, with sequential rounds in id order and in
+// wavefront order, and with synchronous rounds, for the predefined simulations on a few generated city maps. The last
+// round changes nothing, and is counted.
+int main() {
+    cout << "Broadcast rounds until the routing tables converge, average of " << MAPS_PER_PRESET << " city maps" << endl;
+    cout << setw(7) << "Nodes" << setw(8) << "Power" << setw(12) << "Id order" << setw(12) << "Wavefront"
+         << setw(13) << "Synchronous" << setw(12) << "Id ms" << setw(14) << "Wavefront ms" << setw(16)
+         << "Synchronous ms" << endl;
+
+    SequentialRounds idOrder(BroadcastOrder::ID);
+    SequentialRounds wavefront(BroadcastOrder::WAVEFRONT);
+    SynchronousRounds synchronous(static_cast<int>(thread::hardware_concurrency()));
+    vector<function<int(const vector<Node*>&)>> modes = {
+            [&](const vector<Node*>& nodes) { return idOrder.runRound(nodes); },
+            [&](const vector<Node*>& nodes) { return wavefront.runRound(nodes); },
+            [&](const vector<Node*>& nodes) { return synchronous.runRound(nodes); }};
+
+    for (const auto& [numberOfNodes, signalStrength] : PRESETS) {
+        vector<double> totalRounds(modes.size(), 0), milliseconds(modes.size(), 0);
+        vector<bool> converged(modes.size(), true);
+        for (int map = 0; map < MAPS_PER_PRESET; ++map) {
+            Topography topography;
+            topography.setElevationData(topography.generateCityElevation(MAP_SIZE, MAP_SIZE, 20, 80, 1000, 15, 100));
+            auto positions = scatterNodes(topography, numberOfNodes, 1000 + map);
+            for (size_t mode = 0; mode < modes.size(); ++mode) {
+                idOrder.setOrder(BroadcastOrder::ID);
+                wavefront.setOrder(BroadcastOrder::WAVEFRONT);
+                int rounds = roundsToConverge(topography, positions, signalStrength, modes[mode],
+                                              numberOfNodes + 10, milliseconds[mode]);
+                converged[mode] = converged[mode] && rounds > 0;
+                totalRounds[mode] += rounds;
+            }
+        }
+        cout << setw(7) << numberOfNodes << setw(8) << signalStrength << fixed << setprecision(1);
+        for (size_t mode = 0; mode < modes.size(); ++mode) {
+            cout << setw(mode == 2 ? 13 : 12);
+            if (converged[mode]) {
+                cout << totalRounds[mode] / MAPS_PER_PRESET;
+            } else {
+                cout << "-";
+            }
+        }
+        for (size_t mode = 0; mode < modes.size(); ++mode) {
+            cout << setw(mode == 0 ? 12 : mode == 1 ? 14 : 16) << milliseconds[mode] / MAPS_PER_PRESET;
+        }
+        cout << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include "../routing/RoutingTable.h"
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+// The routing table and merge used before the dense table, kept here for comparison
+using MapRoutingTable = map<int, tuple<int, double, int>>;
+
+void mapMerge(MapRoutingTable& routingTable, const MapRoutingTable& tableB, int neighborId) {
+    MapRoutingTable tableA = routingTable;
+    for (const auto& [destination, entryB] : tableB) {
+        int nextHopB, numHopsB, seqNumberB;
+        tie(nextHopB, numHopsB, seqNumberB) = entryB;
+
+        if (tableA.find(destination) == tableA.end()) {
+            tableA[destination] = make_tuple(neighborId, numHopsB + 1, seqNumberB);
+        }
+        else {
+            auto& [_, numHopsA, seqNumberA] = tableA[destination];
+
+            if (seqNumberB > seqNumberA) {
+                tableA[destination] = make_tuple(neighborId, numHopsB + 1, seqNumberB);
+            }
+            else if (seqNumberB == seqNumberA && numHopsB + 1 < numHopsA) {
+                tableA[destination] = make_tuple(neighborId, numHopsB + 1, seqNumberB);
+            }
+        }
+    }
+    routingTable = tableA;
+}
+
+// Returns the average time in microseconds of running merge on a fresh copy of the table, minus the time of the copy
+template<typename Table>
+double timeMerge(const Table& own, const function<void(Table&)>& merge, int repetitions) {
+    auto measure = [&](bool withMerge) {
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < repetitions; ++i) {
+            Table table = own;
+            if (withMerge) {
+                merge(table);
+            }
+        }
+        return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / repetitions;
+    };
+    measure(true);  // Warm up
+    return max(measure(true) - measure(false), 0.0);
+}
+
+// Compares the merge of a table received from a neighbor, for the old map-based table and for the dense table with
+// and without SIMD, in networks where both nodes know every destination. About a third of the received routes have a
+// newer sequence number, and a few of the others are shorter.
+int main() {
+    mt19937 rng(2104);
+    cout << "Merge of one received routing table, in microseconds" << endl;
+    cout << setw(10) << "Nodes" << setw(14) << "std::map" << setw(14) << "Sparse" << setw(14) << "Dense"
+         << setw(14) << "Dense SIMD" << setw(10) << "Speedup" << endl;
+
+    for (int nodes : {1000, 10000, 50000}) {
+        MapRoutingTable mapOwn, mapReceived;
+        DenseRoutingTable denseOwn, denseReceived;
+        SparseRoutingTable sparseOwn, sparseReceived;
+        uniform_int_distribution<int> hopDistribution(1, 20);
+        uniform_int_distribution<int> nodeDistribution(0, nodes - 1);
+        for (int destination = 0; destination < nodes; ++destination) {
+            int sequenceNumber = 2 * uniform_int_distribution<int>(0, 1000)(rng);
+            RouteEntry own{nodeDistribution(rng), static_cast<uint16_t>(hopDistribution(rng)), sequenceNumber};
+            RouteEntry received{nodeDistribution(rng), static_cast<uint16_t>(hopDistribution(rng)),
+                                sequenceNumber + (rng() % 3 == 0 ? 2 : 0)};
+            mapOwn[destination] = make_tuple(own.nextHop, own.hops, own.sequenceNumber);
+            mapReceived[destination] = make_tuple(received.nextHop, received.hops, received.sequenceNumber);
+            denseOwn.set(destination, own);
+            denseReceived.set(destination, received);
+            sparseOwn.set(destination, own);
+            sparseReceived.set(destination, received);
+        }
+
+        int neighborId = nodeDistribution(rng);
+        int repetitions = max(20, 2000000 / nodes);
+        double mapTime = timeMerge<MapRoutingTable>(mapOwn, [&](MapRoutingTable& table) {
+            mapMerge(table, mapReceived, neighborId);
+        }, max(5, repetitions / 20));
+        double sparseTime = timeMerge<SparseRoutingTable>(sparseOwn, [&](SparseRoutingTable& table) {
+            table.merge(sparseReceived, neighborId, NO_OWN_ID);
+        }, repetitions);
+        double scalarTime = timeMerge<DenseRoutingTable>(denseOwn, [&](DenseRoutingTable& table) {
+            table.merge(denseReceived, neighborId, NO_OWN_ID, nullptr, false);
+        }, repetitions);
+        double simdTime = timeMerge<DenseRoutingTable>(denseOwn, [&](DenseRoutingTable& table) {
+            table.merge(denseReceived, neighborId, NO_OWN_ID, nullptr, true);
+        }, repetitions);
+
+        // Every variant has to end up with the same table
+        MapRoutingTable mapResult = mapOwn;
+        mapMerge(mapResult, mapReceived, neighborId);
+        DenseRoutingTable scalarResult = denseOwn, simdResult = denseOwn;
+        int scalarChanges = scalarResult.merge(denseReceived, neighborId, NO_OWN_ID, nullptr, false);
+        int simdChanges = simdResult.merge(denseReceived, neighborId, NO_OWN_ID, nullptr, true);
+        bool same = scalarChanges == simdChanges;
+        for (int destination = 0; destination < nodes; ++destination) {
+            RouteEntry scalar = scalarResult.get(destination);
+            RouteEntry simd = simdResult.get(destination);
+            auto [nextHop, hops, sequenceNumber] = mapResult[destination];
+            same = same && scalar.nextHop == simd.nextHop && scalar.hops == simd.hops &&
+                   scalar.sequenceNumber == simd.sequenceNumber && scalar.nextHop == nextHop &&
+                   scalar.hops == hops && scalar.sequenceNumber == sequenceNumber;
+        }
+
+        cout << fixed << setprecision(1) << setw(10) << nodes << setw(14) << mapTime << setw(14) << sparseTime
+             << setw(14) << scalarTime << setw(14) << simdTime << setw(9) << mapTime / max(simdTime, 0.1) << "x"
+             << (same ? "" : "  results differ!") << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "../node/Node.h"
+#include "../network/LinkGraph.h"
+#include "../simulation/NodeTimers.h"
+#include "../topography/Topography.h"
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+// The node count and signal strength of some of the predefined simulations
+const vector<pair<int, int>> PRESETS = {{50, 6000}, {100, 2000}, {200, 400}, {600, 70}};
+const int MAP_SIZE = 500;
+const int TOPOLOGY_CHANGES = 10;
+// The simulated seconds that are watched after every topology change, and how often the tables are checked
+const double WINDOW_SECONDS = 120;
+const double CHECK_SECONDS = 0.5;
+const double WARM_UP_SECONDS = 600;
+
+struct Mode {
+    string name;
+    bool triggered;
+    double minInterval;
+    double jitter;
+};
+
+struct ModeResult {
+    double repairSeconds = 0;
+    int unrepaired = 0;
+    int broadcasts = 0;
+    int triggeredBroadcasts = 0;
+};
+
+// Returns a random position on the map above the ground, like the predefined simulations use
+tuple<int, int, int> randomPosition(Topography& topography, mt19937& rng) {
+    int x = uniform_int_distribution<int>(1, MAP_SIZE - 1)(rng);
+    int y = uniform_int_distribution<int>(1, MAP_SIZE - 1)(rng);
+    int z = uniform_int_distribution<int>(1, 20)(rng);
+    if (topography.getHeight(x, y) > z) {
+        z += topography.getHeight(x, y) + 1;
+    }
+    return {x, y, z};
+}
+
+// Finds which destinations every node can reach, by a breadth first search over the links from every destination
+vector<vector<bool>> findReachable(const vector<Node*>& nodes) {
+    int count = static_cast<int>(nodes.size());
+    vector<vector<int>> receivers(count);
+    for (Node* node : nodes) {
+        for (Node* receiver : node->getNodesInRadius()) {
+            receivers[node->getId()].push_back(receiver->getId());
+        }
+    }
+    vector<vector<bool>> reachable(count, vector<bool>(count, false));
+    vector<int> queue;
+    for (int destination = 0; destination < count; ++destination) {
+        reachable[destination][destination] = true;
+        queue.assign(1, destination);
+        for (size_t next = 0; next < queue.size(); ++next) {
+            for (int receiver : receivers[queue[next]]) {
+                if (!reachable[receiver][destination]) {
+                    reachable[receiver][destination] = true;
+                    queue.push_back(receiver);
+                }
+            }
+        }
+    }
+    return reachable;
+}
+
+// Whether every node has a working route to exactly the destinations it can reach, and no working route to the rest
+bool tablesMatch(const vector<Node*>& nodes, const vector<vector<bool>>& reachable) {
+    for (Node* node : nodes) {
+        for (int destination = 0; destination < static_cast<int>(nodes.size()); ++destination) {
+            bool hasRoute = node->getRoutingTable().get(destination).hops != RouteEntry::INFINITE_HOPS;
+            if (hasRoute != reachable[node->getId()][destination]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Lets the tables settle, then moves a random node to a random position a number of times, and measures how long the
+// tables take to match the new links and how many broadcasts are sent in the window after each move. The positions,
+// moves and timers come from the same seeds for every mode.
+ModeResult measure(Topography& topography, int numberOfNodes, int signalStrength, unsigned seed, const Mode& mode) {
+    mt19937 rng(seed);
+    deque<Node> nodes;
+    vector<Node*> nodePointers;
+    for (int i = 0; i < numberOfNodes; ++i) {
+        auto [x, y, z] = randomPosition(topography, rng);
+        nodes.emplace_back(i, x, y, z, signalStrength, &topography);
+        nodePointers.push_back(&nodes.back());
+    }
+    for (Node* node : nodePointers) {
+        node->updateAllNodes(nodePointers);
+    }
+    LinkGraph linkGraph(&topography);
+    linkGraph.build(nodePointers);
+
+    NodeTimers timers(NodeTimers::DEFAULT_TICK_SECONDS, seed);
+    timers.reset(0);
+    timers.setTriggeredUpdates(mode.triggered, mode.minInterval, mode.jitter);
+    double time = 0;
+    auto reachable = findReachable(nodePointers);
+    while (time < WARM_UP_SECONDS && !tablesMatch(nodePointers, reachable)) {
+        time += CHECK_SECONDS;
+        timers.advanceTo(nodePointers, time);
+    }
+
+    ModeResult result;
+    for (int change = 0; change < TOPOLOGY_CHANGES; ++change) {
+        Node* moved = nodePointers[uniform_int_distribution<int>(0, numberOfNodes - 1)(rng)];
+        auto [x, y, z] = randomPosition(topography, rng);
+        moved->setPosition(x, y, z);
+        reachable = findReachable(nodePointers);
+
+        int broadcastsBefore = timers.getBroadcasts();
+        int triggeredBefore = timers.getTriggeredBroadcasts();
+        double changeTime = time;
+        double repairedAfter = -1;
+        while (time < changeTime + WINDOW_SECONDS) {
+            time += CHECK_SECONDS;
+            timers.advanceTo(nodePointers, time);
+            if (repairedAfter < 0 && tablesMatch(nodePointers, reachable)) {
+                repairedAfter = time - changeTime;
+            }
+        }
+        result.broadcasts += timers.getBroadcasts() - broadcastsBefore;
+        result.triggeredBroadcasts += timers.getTriggeredBroadcasts() - triggeredBefore;
+        if (repairedAfter < 0) {
+            result.unrepaired++;
+            repairedAfter = WINDOW_SECONDS;
+        }
+        result.repairSeconds += repairedAfter;
+    }
+    return result;
+}
+
+// Compares the regular broadcasts alone with triggered updates, sent at once or limited by a minimum interval and a
+// jitter, when nodes that broadcast on their own timers move. For every mode it prints the average time until all
+// routing tables match the links again, the broadcasts in the window after a move, and how many of them were
+// triggered updates.
+int main() {
+    vector<Mode> modes = {
+            {"Regular only", false, 0, 0},
+            {"Triggered, no limit", true, 0, 0},
+            {"Triggered, limited", true, NodeTimers::DEFAULT_MIN_TRIGGERED_INTERVAL, NodeTimers::DEFAULT_TRIGGER_JITTER}};
+    cout << "Per topology change, average of " << TOPOLOGY_CHANGES << " moves, " << WINDOW_SECONDS
+         << " simulated seconds watched after each" << endl;
+    cout << setw(7) << "Nodes" << setw(8) << "Power" << "  " << left << setw(22) << "Mode" << right << setw(11)
+         << "Repair s" << setw(13) << "Broadcasts" << setw(12) << "Triggered" << setw(13) << "Unrepaired" << endl;
+
+    for (const auto& [numberOfNodes, signalStrength] : PRESETS) {
+        Topography topography;
+        topography.setElevationData(topography.generateCityElevation(MAP_SIZE, MAP_SIZE, 20, 80, 1000, 15, 100));
+        for (const Mode& mode : modes) {
+            ModeResult result = measure(topography, numberOfNodes, signalStrength, 2000 + numberOfNodes, mode);
+            cout << setw(7) << numberOfNodes << setw(8) << signalStrength << "  " << left << setw(22) << mode.name
+                 << right << fixed << setprecision(1) << setw(11) << result.repairSeconds / TOPOLOGY_CHANGES
+                 << setw(13) << static_cast<double>(result.broadcasts) / TOPOLOGY_CHANGES << setw(12)
+                 << static_cast<double>(result.triggeredBroadcasts) / TOPOLOGY_CHANGES << setw(13)
+                 << result.unrepaired << endl;
+        }
+    }
+    return 0;
+}
@@ -1,11 +1,29 @@
 #include <iostream>
 #include <string>
 #include <thread>
+#include <mutex>
 #include <vector>
+#include <deque>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <future>
 #include <random>
 #include "node/Node.h"
+#include "network/LinkGraph.h"
+#include "network/SequentialRounds.h"
+#include "network/SynchronousRounds.h"
+#include "network/AsynchronousGossip.h"
+#include "simulation/EventQueue.h"
+#include "simulation/NodeTimers.h"
 #include "worker/Workers.h"
 #include "topography/Topography.h"
+#include "render/SvgExporter.h"
+#include "render/TileExporter.h"
+#include "render/FrameRecorder.h"
+#include "render/ImageExportQueue.h"
+#include "render/ServiceAreaMap.h"
+#include "render/LinkLoadMap.h"
 #include <map>
 #include <functional>
 #include <filesystem>
@@ -19,12 +37,43 @@
 
 using namespace std;
 
-vector<Node> nodes;
+// A deque, so the nodes keep their addresses when nodes are created
+deque<Node> nodes;
 vector<Node*> nodePointers;
 bool stop = false;
 Topography topography;
+LinkGraph linkGraph(&topography);
 vector<vector<int>> heightData;
 int fileNumber = 0;
+BitmapFormat imageFormat = BitmapFormat::RGB24;
+SvgExporter svgExporter(&topography);
+TileExporter tileExporter(&topography, "SimulationTiles", static_cast<int>(thread::hardware_concurrency()));
+// Held by a broadcast round, so the CLI can change how the rounds broadcast and read how many ran in between rounds
+mutex broadcastMutex;
+FrameRecorder frameRecorder(&topography);
+ImageExportQueue imageExportQueue(&topography);
+ServiceAreaMap serviceAreaMap(&topography);
+LinkLoadMap linkLoadMap(&topography, static_cast<int>(thread::hardware_concurrency()));
+int recordingNumber = 0;
+// How many broadcasts there are between the full routing table dumps of every node
+int fullDumpInterval = Node::DEFAULT_FULL_DUMP_INTERVAL;
+// When set, the broadcast rounds are synchronous and run on all cores, instead of the nodes broadcasting one by one
+bool synchronousBroadcasting = false;
+SequentialRounds sequentialRounds(BroadcastOrder::ID);
+SynchronousRounds synchronousRounds(static_cast<int>(thread::hardware_concurrency()));
+// When set, every node broadcasts on its own timer instead of in rounds, and routes through silent neighbors expire
+bool timerBroadcasting = false;
+NodeTimers nodeTimers(NodeTimers::DEFAULT_TICK_SECONDS, random_device{}());
+// The time between the broadcast rounds while the simulation is running
+const int BROADCAST_INTERVAL_SECONDS = 5;
+// The number of broadcast intervals a gossip run may simulate
+const int GOSSIP_INTERVALS = 100;
+// The events of the running simulation: the broadcast rounds and the node moves, on a virtual clock paced to real time
+EventQueue simulationEvents;
+int broadcastRounds = 0;
+// The path of the last message that was sent, drawn on the recorded frames
+vector<pair<Node*, Node*>> lastMessagePath;
+mutex messagePathMutex;
 int width;
 int height;
 
@@ -39,32 +88,88 @@ void updateNodePointers(vector<Node*>& inputNodes) {
 }
 
 // This method broadcasts the routing table to all inputNodes in range. Nodes in range will update their routing table
-// based on the information they receive.
-void broadcastNodes(vector<Node*>& inputNodes, int numberOfBroadcasts) {
-    for (int i = 0; i < numberOfBroadcasts; i++) {
-        for (auto& node : inputNodes) {
-            node->broadcast();
+// based on the information they receive. In synchronous mode every node broadcasts at the same time, and the nodes
+// receive the tables their neighbors had before the round. Returns the number of routes that changed in the round.
+int broadcastRound(vector<Node*>& inputNodes) {
+    if (synchronousBroadcasting) {
+        return synchronousRounds.runRound(inputNodes);
+    }
+    return sequentialRounds.runRound(inputNodes);
+}
+
+// Broadcasts until quietRounds rounds in a row change no routes, or until maxRounds rounds have run without that, and
+// prints how many rounds it took. The quiet rounds that end the startup are not counted against maxRounds. With full
+// dumps in every broadcast the sequence numbers can keep moving routes between equally long paths, so the tables may
+// never settle, and maxRounds is the limit. Returns the number of rounds that ran.
+int broadcastUntilConverged(vector<Node*>& inputNodes, int maxRounds, int quietRounds) {
+    auto start = chrono::steady_clock::now();
+    int rounds = 0;
+    int roundsWithoutChanges = 0;
+    int changes = 0;
+    while (rounds - roundsWithoutChanges < maxRounds && roundsWithoutChanges < quietRounds) {
+        changes = broadcastRound(inputNodes);
+        roundsWithoutChanges = changes == 0 ? roundsWithoutChanges + 1 : 0;
+        rounds++;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (roundsWithoutChanges >= quietRounds) {
+        cout << "Routing tables converged after " << rounds << " broadcast rounds in " << seconds << " seconds" << endl;
+    } else {
+        cout << "Routing tables did not converge in " << rounds << " broadcast rounds (" << seconds << " seconds), "
+             << changes << " routes changed in the last round" << endl;
+    }
+    return rounds;
+}
+
+// Collects every pair of nodes that are in radio range of each other, for drawing the network. Runs as an event, since
+// the links change when nodes move.
+vector<pair<Node*, Node*>> collectRadioLinks() {
+    vector<pair<Node*, Node*>> radioLinks;
+    for (auto& node : nodePointers) {
+        for (auto& neighbor : node->getNodesInRadius()) {
+            if (node->getId() < neighbor->getId()) {
+                radioLinks.emplace_back(node, neighbor);
+            }
         }
     }
+    return radioLinks;
+}
+
+// Runs an action as an event and waits until it is done. The commands that read the routing tables, the positions or
+// the links run this way, so they never see a node in the middle of a broadcast, a move or a timer.
+void runAsEvent(const function<void()>& action) {
+    promise<void> done;
+    simulationEvents.post([&action, &done] {
+        action();
+        done.set_value();
+    });
+    done.get_future().wait();
 }
 
 void printRoutingTables() {
-    for (auto& node : nodes) {
-        node.printRoutingTable();
-    }
+    runAsEvent([] {
+        for (auto& node : nodes) {
+            node.printRoutingTable();
+        }
+    });
 }
 
+// The node is moved by an event, so the move happens between two broadcast rounds. Waits until the node has moved.
 void changeNodePosition(int nodeId, int x, int y, int z) {
-    Node& node = nodes[nodeId];
-    node.setPosition(x, y, z);
+    runAsEvent([nodeId, x, y, z] {
+        Node& node = nodes[nodeId];
+        node.setPosition(x, y, z);
+    });
 }
 
 void getNodeInfo(int nodeId) {
     // Print routing table and position
-    const Node& node = nodes[nodeId];
-    cout << "----------- Node " << nodeId << " -----------" << endl;
-    cout << "Position: (" << node.getX() << ", " << node.getY() << ", " << node.getZ() << ")" << endl;
-    node.printRoutingTable();
+    runAsEvent([nodeId] {
+        const Node& node = nodes[nodeId];
+        cout << "----------- Node " << nodeId << " -----------" << endl;
+        cout << "Position: (" << node.getX() << ", " << node.getY() << ", " << node.getZ() << ")" << endl;
+        node.printRoutingTable();
+    });
 }
 
 void sendMessage(int senderId, int receiverId, const string& message, vector<pair<Node*, Node*>>& connectedDrones) {
@@ -75,13 +180,51 @@ void sendMessage(int senderId, int receiverId, const string& message, vector<pai
     }
 }
 
-// Every node broadcasts its routing table every 15 seconds.
+// Schedules a broadcast round at a simulated time. While a recording is running, a frame is recorded after the round.
+// The round schedules the next one, so there is a round every BROADCAST_INTERVAL_SECONDS. When the nodes broadcast on
+// their own timers, the round only records the frame.
+void scheduleBroadcastRound(double time) {
+    simulationEvents.schedule(time, [time] {
+        {
+            lock_guard<mutex> lock(broadcastMutex);
+            if (!timerBroadcasting) {
+                broadcastRound(nodePointers);
+                broadcastRounds++;
+            }
+        }
+        if (frameRecorder.isRecording()) {
+            vector<pair<Node*, Node*>> messagePath;
+            {
+                lock_guard<mutex> lock(messagePathMutex);
+                messagePath = lastMessagePath;
+            }
+            frameRecorder.recordFrame(nodePointers, messagePath);
+        }
+        scheduleBroadcastRound(time + BROADCAST_INTERVAL_SECONDS);
+    });
+}
+
+// Schedules a tick of the node timers at a simulated time, which runs the timers that are due when the nodes broadcast
+// on their own timers. The tick schedules the next one.
+void scheduleNodeTimers(double time) {
+    simulationEvents.schedule(time, [time] {
+        {
+            lock_guard<mutex> lock(broadcastMutex);
+            if (timerBroadcasting) {
+                nodeTimers.advanceTo(nodePointers, time);
+            }
+        }
+        scheduleNodeTimers(time + NodeTimers::DEFAULT_TICK_SECONDS);
+    });
+}
+
+// Runs the events of the simulation until the program quits, paced so one simulated second takes one second. Every
+// node broadcasts its routing table every 5 seconds.
 void regularBroadcasting() {
-    while(!stop) {
-        broadcastNodes(nodePointers, 1);
-        // Sleep for 15 seconds
-        this_thread::sleep_for(chrono::seconds(5));
-    }
+    scheduleBroadcastRound(simulationEvents.now());
+    scheduleNodeTimers(simulationEvents.now());
+    simulationEvents.setPacing(1.0);
+    simulationEvents.runUntil(numeric_limits<double>::infinity());
 }
 
 pair<int, int> getTerminalSize() {
@@ -110,6 +253,21 @@ void printHelp() {
     cout << "send: send a message from a node to another node. Also generates an image that shows the path chosen" << endl;
     cout << "help: print this help message" << endl;
     cout << "save: save the topography to a file" << endl;
+    cout << "live: watch a live view of the network in the console" << endl;
+    cout << "format: choose the pixel format of generated images" << endl;
+    cout << "tiles: export the map as a pyramid of tiles that can be browsed with a tile viewer" << endl;
+    cout << "record: start or stop recording a frame of the network after every broadcast round" << endl;
+    cout << "load: generate a heat map of how many routes use each link, and list the busiest links" << endl;
+    cout << "areas: generate an image that shows the nearest node of every point, or its hop count to a node" << endl;
+    cout << "dumps: choose how often the nodes broadcast their whole routing table instead of only the changes" << endl;
+    cout << "rounds: choose whether the nodes broadcast one by one, in id or wavefront order, all at the same time, or "
+            "each on its own timer" << endl;
+    cout << "interval: change the time between the broadcasts of a node, when the nodes broadcast on their own timers"
+         << endl;
+    cout << "triggers: choose whether routes that appear or break are sent at once, when the nodes broadcast on their "
+            "own timers" << endl;
+    cout << "gossip: let every node broadcast at its own jittered times, and show when the nodes converged" << endl;
+    cout << "skip: run a number of simulated minutes as fast as possible" << endl;
 }
 
 
@@ -157,10 +315,16 @@ void createNodeCLI() {
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
 
+    // The node is added by an event, so it joins between two broadcast rounds
     int nodeId = nodes.size();
-    Node node(nodeId, x, y, z, signalStrength, &topography); // Set signal strength to 0 for now
-    nodes.push_back(node);
-    nodePointers.push_back(&nodes[nodeId]);
+    runAsEvent([nodeId, x, y, z, signalStrength] {
+        Node node(nodeId, x, y, z, signalStrength, &topography);
+        node.setFullDumpInterval(fullDumpInterval);
+        nodes.push_back(node);
+        nodePointers.push_back(&nodes[nodeId]);
+        updateNodePointers(nodePointers);
+        linkGraph.addNode(&nodes[nodeId]);
+    });
 
     cout << "Node created with ID: " << nodeId << endl;
     cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
@@ -188,28 +352,475 @@ void sendMessageCLI() {
     int choice;
     cout << "[1]: Only send message" << endl;
     cout << "[2]: Send message and generate image to file" << endl;
-    cout << "[3]: Send message and print image to console (not recommended if width is wider than the console)" << endl;
+    cout << "[3]: Send message and print image to console (zoomed out to fit the console)" << endl;
+    cout << "[4]: Send message and generate image of a part of the map to file" << endl;
+    cout << "[5]: Send message and generate image to file, starting with a coarse preview" << endl;
+    cout << "[6]: Send message and export the network and the path to an SVG file" << endl;
     cout << ">> ";
     cin >> choice;
 
-    sendMessage(senderId, receiverId, message, connectedDrones);
+    Viewport viewport;
+    if(choice == 4) {
+        cout << "Enter the top left corner, width and height of the part to render (x, y, width, height): ";
+        while (!(cin >> viewport.x >> viewport.y >> viewport.width >> viewport.height) || viewport.x < 0 ||
+               viewport.y < 0 || viewport.width <= 0 || viewport.height <= 0 || viewport.x > width-1 || viewport.y > height-1) {
+            cout << "Invalid area. Please enter valid x, y, width and height: ";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        cout << "Enter the zoom level (1 is full size, 2 is half size, ...): ";
+        while (!(cin >> viewport.zoom) || viewport.zoom < 1) {
+            cout << "Invalid zoom level. Please enter a positive number: ";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
+
+    // The message is sent, and the nodes are copied for the image or written to the SVG file, between two events
+    bool submitted = false;
+    std::string directory = "SimulationPictures";
+    std::string filename = directory + "/" + std::to_string(fileNumber) + (choice == 6 ? ".svg" : ".bmp");
+    if ((choice == 2 || choice == 4 || choice == 5 || choice == 6) && !std::filesystem::exists(directory)) {
+        std::filesystem::create_directory(directory);
+    }
+    runAsEvent([&] {
+        sendMessage(senderId, receiverId, message, connectedDrones);
+        if (choice == 2 || choice == 4 || choice == 5) {
+            submitted = imageExportQueue.submit(nodePointers, connectedDrones, filename, viewport, imageFormat,
+                                                choice == 5);
+        }
+        if (choice == 6) {
+            svgExporter.write(nodePointers, collectRadioLinks(), connectedDrones, filename);
+        }
+    });
+    {
+        lock_guard<mutex> lock(messagePathMutex);
+        lastMessagePath = connectedDrones;
+    }
 
-    if(choice == 2) {
-        std::string directory = "SimulationPictures";
-        if (!std::filesystem::exists(directory)) {
-            std::filesystem::create_directory(directory);
+    if(choice == 2 || choice == 4 || choice == 5) {
+        // The image is written in the background, and a message is printed when it is done
+        if (submitted) {
+            std::cout << "Generating " << filename << " in the background." << std::endl;
+            fileNumber++;
+        } else {
+            std::cout << "Too many images are being generated. Please try again when one of them is done." << std::endl;
         }
-        std::string filename = directory + "/" + std::to_string(fileNumber) + ".bmp";
-        std::cout << "Generating image file. Please wait..." << std::endl;
-        topography.writeMapToBMP(nodePointers, connectedDrones, filename);
-        std::cout << "image saved to " << filename << std::endl;
+    }
+    if(choice == 6) {
+        std::cout << "SVG saved to " << filename << std::endl;
         fileNumber++;
     }
     if(choice == 3) {
-        topography.printMapToConsole(nodePointers, connectedDrones);
+        // The coverage is refined in place, so the whole map has to fit on the screen
+        pair<int, int> terminalSize = getTerminalSize();
+        Viewport fitted = topography.fitViewport(terminalSize.first, terminalSize.second - 1);
+        runAsEvent([&] {
+            topography.printMapToConsoleProgressive(nodePointers, connectedDrones, false, fitted);
+        });
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
+
+}
+
+void imageFormatCLI() {
+    int choice;
+    cout << "[0]: 24-bit color (largest files, exact colors)" << endl;
+    cout << "[1]: 8-bit palette" << endl;
+    cout << "[2]: 8-bit palette with RLE compression (smallest files)" << endl;
+    cout << ">> ";
+    while (!(cin >> choice) || choice < 0 || choice > 2) {
+        cout << "Invalid choice. Please select 0, 1 or 2: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    imageFormat = choice == 0 ? BitmapFormat::RGB24 : choice == 1 ? BitmapFormat::INDEXED8 : BitmapFormat::RLE8;
+    cout << "Image format changed!" << endl;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
+}
+
+// Sets how many broadcasts there are between the full routing table dumps. The broadcasts in between only send the
+// routes that changed since the last full dump.
+void fullDumpIntervalCLI() {
+    int interval;
+    cout << "Current interval: a full dump every " << fullDumpInterval << " broadcasts" << endl;
+    cout << "Enter the number of broadcasts between full dumps (1 sends the whole table every time): ";
+    while (!(cin >> interval) || interval < 1) {
+        cout << "Invalid interval. Please enter a number of at least 1: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    {
+        // The nodes read the interval when they broadcast
+        lock_guard<mutex> lock(broadcastMutex);
+        fullDumpInterval = interval;
+        for (auto& node : nodePointers) {
+            node->setFullDumpInterval(fullDumpInterval);
+        }
+    }
+    cout << "Full dump interval changed!" << endl;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
+}
+
+// Chooses how the broadcast rounds are run. Sequential rounds let a node pass on what it received earlier in the same
+// round, and in wavefront order the nodes broadcast in the order the routes spread. Synchronous rounds only pass routes
+// one hop per round, but the nodes are updated in parallel, and the result does not depend on the number of threads.
+// With timers there are no rounds: every node broadcasts at its own interval, and routes expire when their next hop
+// has not been heard for a while.
+void broadcastModeCLI() {
+    int choice;
+    cout << "[0]: Sequential, the nodes broadcast one by one in id order" << endl;
+    cout << "[1]: Sequential, the nodes broadcast one by one in wavefronts over the links" << endl;
+    cout << "[2]: Synchronous, every node broadcasts at the same time, on all cores" << endl;
+    cout << "[3]: Timers, every node broadcasts at its own interval, and routes through silent neighbors expire"
+         << endl;
+    cout << ">> ";
+    while (!(cin >> choice) || choice < 0 || choice > 3) {
+        cout << "Invalid choice. Please select 0, 1, 2 or 3: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
+    {
+        lock_guard<mutex> lock(broadcastMutex);
+        synchronousBroadcasting = choice == 2;
+        sequentialRounds.setOrder(choice == 1 ? BroadcastOrder::WAVEFRONT : BroadcastOrder::ID);
+        if (choice == 3 && !timerBroadcasting) {
+            nodeTimers.reset(simulationEvents.now());
+        }
+        timerBroadcasting = choice == 3;
+    }
+    cout << "Broadcast rounds changed!" << endl;
     cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
+}
 
+// Sets the time between the broadcasts of one node. Routes through the node expire after NodeTimers::EXPIRY_INTERVALS
+// of its intervals without a broadcast, so a longer interval also makes its neighbors wait longer.
+void broadcastIntervalCLI() {
+    int nodeId;
+    double seconds;
+    cout << "Enter the ID of the node: ";
+    while (!(cin >> nodeId) || nodeId < 0 || nodeId >= static_cast<int>(nodes.size())) {
+        cout << "Invalid node ID. Please enter a valid node ID: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    {
+        lock_guard<mutex> lock(broadcastMutex);
+        cout << "Current interval: " << nodes[nodeId].getBroadcastInterval() << " seconds" << endl;
+    }
+    cout << "Enter the number of seconds between the broadcasts of the node: ";
+    while (!(cin >> seconds) || seconds < NodeTimers::DEFAULT_TICK_SECONDS) {
+        cout << "Invalid interval. Please enter at least " << NodeTimers::DEFAULT_TICK_SECONDS << " seconds: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    {
+        lock_guard<mutex> lock(broadcastMutex);
+        nodes[nodeId].setBroadcastInterval(seconds);
+    }
+    cout << "Broadcast interval changed!";
+    if (!timerBroadcasting) {
+        cout << " It is used when the nodes broadcast on their own timers, see the \"rounds\" command.";
+    }
+    cout << endl;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
+}
+
+// Turns the triggered updates of the node timers on or off, and sets how far apart the updates of a node must be and
+// how much random jitter delays them.
+void triggeredUpdatesCLI() {
+    string answer;
+    double minInterval, jitter;
+    {
+        lock_guard<mutex> lock(broadcastMutex);
+        cout << "Triggered updates are " << (nodeTimers.getTriggeredUpdates() ? "on" : "off") << ", at least "
+             << nodeTimers.getMinTriggeredInterval() << " seconds apart, with up to " << nodeTimers.getTriggerJitter()
+             << " seconds of jitter" << endl;
+    }
+    cout << "Send an update at once when routes appear or break? (y/n): ";
+    while (!(cin >> answer) || (answer != "y" && answer != "n")) {
+        cout << "Invalid answer. Please enter y or n: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    bool enabled = answer == "y";
+    minInterval = NodeTimers::DEFAULT_MIN_TRIGGERED_INTERVAL;
+    jitter = NodeTimers::DEFAULT_TRIGGER_JITTER;
+    if (enabled) {
+        cout << "Enter the minimum number of seconds between two updates of a node: ";
+        while (!(cin >> minInterval) || minInterval < 0) {
+            cout << "Invalid interval. Please enter a number of at least 0: ";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        cout << "Enter the largest random delay of an update in seconds: ";
+        while (!(cin >> jitter) || jitter < 0) {
+            cout << "Invalid jitter. Please enter a number of at least 0: ";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
+    {
+        lock_guard<mutex> lock(broadcastMutex);
+        nodeTimers.setTriggeredUpdates(enabled, minInterval, jitter);
+    }
+    cout << "Triggered updates changed!";
+    if (!timerBroadcasting) {
+        cout << " They are used when the nodes broadcast on their own timers, see the \"rounds\" command.";
+    }
+    cout << endl;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
+}
+
+// Prints the smallest, median, 90th percentile and largest convergence time of the nodes, and how many nodes converged
+// within each broadcast interval. Times below 0 are nodes that never converged.
+void printConvergenceTimes(const string& title, vector<double> times) {
+    vector<double> convergedTimes;
+    for (double time : times) {
+        if (time >= 0) {
+            convergedTimes.push_back(time);
+        }
+    }
+    sort(convergedTimes.begin(), convergedTimes.end());
+    cout << title << ": " << convergedTimes.size() << " of " << times.size() << " nodes" << endl;
+    if (convergedTimes.empty()) {
+        return;
+    }
+    auto percentile = [&](double fraction) {
+        return convergedTimes[static_cast<size_t>(fraction * (convergedTimes.size() - 1))];
+    };
+    cout << fixed << setprecision(1) << "  min " << convergedTimes.front() << " s, median " << percentile(0.5)
+         << " s, 90% " << percentile(0.9) << " s, max " << convergedTimes.back() << " s" << endl;
+    int intervals = static_cast<int>(convergedTimes.back() / BROADCAST_INTERVAL_SECONDS) + 1;
+    vector<int> histogram(intervals, 0);
+    for (double time : convergedTimes) {
+        histogram[static_cast<int>(time / BROADCAST_INTERVAL_SECONDS)]++;
+    }
+    for (int interval = 0; interval < intervals; ++interval) {
+        if (histogram[interval] > 0) {
+            cout << "  " << setw(5) << interval * BROADCAST_INTERVAL_SECONDS << " - " << setw(5)
+                 << (interval + 1) * BROADCAST_INTERVAL_SECONDS << " s: " << string(min(histogram[interval], 60), '#')
+                 << " " << histogram[interval] << endl;
+        }
+    }
+    cout << defaultfloat << setprecision(6);
+}
+
+// Runs the nodes as gossip, where every node broadcasts every 5 simulated seconds with a random jitter, and prints when
+// the nodes converged. The run can start from the current routing tables, or from empty tables to see how long a
+// network takes to converge from the start.
+void gossipCLI() {
+    int jitterPercent, seed, start;
+    cout << "Enter the jitter of the broadcast intervals in percent (0 to 90): ";
+    while (!(cin >> jitterPercent) || jitterPercent < 0 || jitterPercent > 90) {
+        cout << "Invalid jitter. Please enter a number from 0 to 90: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    cout << "Enter the seed of the random broadcast times: ";
+    while (!(cin >> seed)) {
+        cout << "Invalid seed. Please enter a whole number: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    cout << "[0]: Start from the current routing tables" << endl;
+    cout << "[1]: Start from empty routing tables" << endl;
+    cout << ">> ";
+    while (!(cin >> start) || start < 0 || start > 1) {
+        cout << "Invalid choice. Please select 0 or 1: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
+
+    AsynchronousGossip gossip(BROADCAST_INTERVAL_SECONDS, jitterPercent / 100.0, static_cast<unsigned>(seed));
+    GossipResult result;
+    // The run takes the place of the regular rounds until it is done
+    runAsEvent([&gossip, &result, start] {
+        if (start == 1) {
+            for (auto& node : nodePointers) {
+                node->resetRoutingTable();
+            }
+        }
+        result = gossip.run(nodePointers, GOSSIP_INTERVALS * BROADCAST_INTERVAL_SECONDS);
+    });
+    cout << result.broadcasts << " broadcasts in " << result.endTime << " simulated seconds" << endl;
+    if (!result.converged) {
+        cout << "Not every node knew a route to every reachable node within "
+             << GOSSIP_INTERVALS * BROADCAST_INTERVAL_SECONDS << " seconds" << endl;
+    }
+    printConvergenceTimes("Nodes with a route to every reachable node", result.convergenceTimes);
+    printConvergenceTimes("Nodes whose routes had all been the shortest", result.shortestRouteTimes);
+}
+
+// Runs a number of simulated minutes as fast as possible, and then continues in real time.
+void fastForwardCLI() {
+    double minutes;
+    cout << "Enter the number of simulated minutes to skip ahead: ";
+    while (!(cin >> minutes) || minutes <= 0) {
+        cout << "Invalid time. Please enter a positive number of minutes: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
+
+    auto start = chrono::steady_clock::now();
+    int roundsBefore, timerBroadcastsBefore, triggeredBroadcastsBefore, expiredRoutesBefore;
+    {
+        lock_guard<mutex> lock(broadcastMutex);
+        roundsBefore = broadcastRounds;
+        timerBroadcastsBefore = nodeTimers.getBroadcasts();
+        triggeredBroadcastsBefore = nodeTimers.getTriggeredBroadcasts();
+        expiredRoutesBefore = nodeTimers.getExpiredRoutes();
+    }
+    double target = simulationEvents.now() + minutes * 60;
+    promise<void> reached;
+    simulationEvents.fastForward(minutes * 60);
+    simulationEvents.schedule(target, [&reached] {
+        reached.set_value();
+    });
+    reached.get_future().wait();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    lock_guard<mutex> lock(broadcastMutex);
+    if (timerBroadcasting) {
+        // A reset by the rounds command in the meantime starts the counts from 0 again
+        cout << "Simulated " << minutes << " minutes, " << max(nodeTimers.getBroadcasts() - timerBroadcastsBefore, 0)
+             << " broadcasts (" << max(nodeTimers.getTriggeredBroadcasts() - triggeredBroadcastsBefore, 0)
+             << " triggered) and " << max(nodeTimers.getExpiredRoutes() - expiredRoutesBefore, 0)
+             << " expired routes, in " << seconds << " seconds" << endl;
+    } else {
+        cout << "Simulated " << minutes << " minutes, " << broadcastRounds - roundsBefore << " broadcast rounds, in "
+             << seconds << " seconds" << endl;
+    }
+}
+
+// Writes the map as {zoom}/{x}/{y}.bmp tiles. Only tiles that changed since the previous export are written again.
+void exportTilesCLI() {
+    cout << "Exporting tiles. Please wait..." << endl;
+    int tilesWritten = 0;
+    runAsEvent([&tilesWritten] {
+        tilesWritten = tileExporter.exportTiles(nodePointers, {});
+    });
+    cout << tilesWritten << " tiles written to SimulationTiles, with zoom levels 0 to " << tileExporter.getMaxZoom() << endl;
+}
+
+// Counts how many routes use each link according to the routing tables, and writes them as a heat map.
+void linkLoadCLI() {
+    // The loads are counted and drawn in one event, so the image shows the tables and positions they were counted from
+    std::string directory = "SimulationPictures";
+    std::filesystem::create_directories(directory);
+    std::string filename = directory + "/" + std::to_string(fileNumber) + ".bmp";
+    LinkLoadMap::LinkLoads loads;
+    runAsEvent([&loads, &filename] {
+        loads = linkLoadMap.computeLinkLoads(nodePointers);
+        linkLoadMap.write(nodePointers, loads, filename, Viewport());
+    });
+
+    vector<pair<long long, pair<int, int>>> busiest;
+    for (const auto& [link, load] : loads) {
+        busiest.emplace_back(load, link);
+    }
+    sort(busiest.rbegin(), busiest.rend());
+    cout << loads.size() << " links are used by at least one route. The busiest links are:" << endl;
+    for (size_t i = 0; i < busiest.size() && i < 5; ++i) {
+        cout << "Node " << nodePointers[busiest[i].second.first]->getId() << " - Node "
+             << nodePointers[busiest[i].second.second]->getId() << ": " << busiest[i].first << " routes" << endl;
+    }
+
+    cout << "image saved to " << filename << endl;
+    fileNumber++;
+}
+
+// Writes a service area map, where every point is colored by the nearest node in range of it.
+void serviceAreaCLI() {
+    int choice;
+    cout << "[0]: Color every point by its nearest node" << endl;
+    cout << "[1]: Color every point by the number of hops from its nearest node to a destination" << endl;
+    cout << ">> ";
+    while (!(cin >> choice) || choice < 0 || choice > 1) {
+        cout << "Invalid choice. Please select 0 or 1: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    int destination = 0;
+    if (choice == 1) {
+        cout << "Enter the ID of the destination: ";
+        while (!(cin >> destination) || destination < 0 || destination >= nodes.size()) {
+            cout << "Invalid node ID. Please enter a valid node ID: ";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
+
+    std::string directory = "SimulationPictures";
+    std::filesystem::create_directories(directory);
+    std::string filename = directory + "/" + std::to_string(fileNumber) + ".bmp";
+    // The map reads the positions and the routing tables, so it is drawn as an event
+    runAsEvent([&filename, choice, destination] {
+        serviceAreaMap.write(nodePointers, filename, Viewport(),
+                             choice == 0 ? ServiceAreaMode::NEAREST_NODE : ServiceAreaMode::HOP_COUNT, destination);
+    });
+    cout << "image saved to " << filename << endl;
+    fileNumber++;
+}
+
+// Starts recording the network, or stops the recording that is running.
+void recordCLI() {
+    if (frameRecorder.isRecording()) {
+        int frames = frameRecorder.stop();
+        cout << "Recording stopped after " << frames << " frames" << endl;
+        return;
+    }
+
+    int choice;
+    cout << "[0]: Record a numbered sequence of bitmap images" << endl;
+    cout << "[1]: Record an uncompressed Y4M video" << endl;
+    cout << ">> ";
+    while (!(cin >> choice) || choice < 0 || choice > 1) {
+        cout << "Invalid choice. Please select 0 or 1: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
+
+    std::string directory = "SimulationRecordings";
+    std::filesystem::create_directories(directory);
+    RecordingFormat format = choice == 0 ? RecordingFormat::BMP_SEQUENCE : RecordingFormat::Y4M;
+    std::string path = directory + "/" + std::to_string(recordingNumber) + (choice == 0 ? "" : ".y4m");
+    // Large maps are zoomed out, so a recording of a few hundred frames stays manageable
+    if (frameRecorder.start(path, format, topography.fitViewport(1024, 1024))) {
+        recordingNumber++;
+        cout << "Recording to " << path << ". Use the \"record\" command again to stop." << endl;
+    }
+}
+
+// Redraws the map in place for a while. Only the characters that change between frames are written to the console.
+void liveViewCLI() {
+    int seconds;
+    cout << "Enter how many seconds to watch the network: ";
+    while (!(cin >> seconds) || seconds <= 0) {
+        cout << "Invalid duration. Please enter a positive number of seconds: ";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    vector<pair<Node*, Node*>> connectedDrones;
+    auto end = chrono::steady_clock::now() + chrono::seconds(seconds);
+    topography.startLiveView();
+    while (chrono::steady_clock::now() < end) {
+        auto nextFrame = chrono::steady_clock::now() + chrono::milliseconds(100);
+        pair<int, int> terminalSize = getTerminalSize();
+        // Every character shows two rows of the map, and the last line is kept free for the cursor
+        Viewport fitted = topography.fitViewport(terminalSize.first, 2 * (terminalSize.second - 1));
+        runAsEvent([&] {
+            topography.printMapToConsole(nodePointers, connectedDrones, true, true, fitted);
+        });
+        this_thread::sleep_until(nextFrame);
+    }
+    topography.stopLiveView();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
 }
 
 void getNodeInfoCLI() {
@@ -245,7 +856,10 @@ void startCLI() {
 
     commandHandlers["quit"] = commandHandlers["exit"] = commandHandlers["q"] =
     commandHandlers["e"] = commandHandlers["stop"] = commandHandlers["s"] =
-    commandHandlers["end"] = commandHandlers["x"] = [&]() { stop = true; };
+    commandHandlers["end"] = commandHandlers["x"] = [&]() {
+        stop = true;
+        simulationEvents.stop();
+    };
 
     commandHandlers["help"] = printHelp;
     commandHandlers["print"] = printRoutingTables;
@@ -254,6 +868,18 @@ void startCLI() {
     commandHandlers["send"] = sendMessageCLI;
     commandHandlers["nodeInfo"] = getNodeInfoCLI;
     commandHandlers["save"] = saveElevations;
+    commandHandlers["live"] = liveViewCLI;
+    commandHandlers["format"] = imageFormatCLI;
+    commandHandlers["tiles"] = exportTilesCLI;
+    commandHandlers["record"] = recordCLI;
+    commandHandlers["areas"] = serviceAreaCLI;
+    commandHandlers["load"] = linkLoadCLI;
+    commandHandlers["dumps"] = fullDumpIntervalCLI;
+    commandHandlers["rounds"] = broadcastModeCLI;
+    commandHandlers["interval"] = broadcastIntervalCLI;
+    commandHandlers["triggers"] = triggeredUpdatesCLI;
+    commandHandlers["gossip"] = gossipCLI;
+    commandHandlers["skip"] = fastForwardCLI;
 
     cout << "Use the \"help\" command if you are stuck" << endl;
     cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Ignore leftover newline character
@@ -273,7 +899,8 @@ void startCLI() {
     }
 }
 
-// Start the Wireless Mesh simulation with the given parameters.
+// Start the Wireless Mesh simulation with the given parameters. The nodes broadcast until their routing tables stop
+// changing for a full dump interval, but give up after numberOfBroadcasts rounds that do not settle.
 void simulate(vector<tuple<int, int, int>> nodePositions, int numberOfBroadcasts, int signalStrength) {
     for(int i = 0; i < nodePositions.size(); i++) {
         int x = get<0>(nodePositions[i]);
@@ -288,8 +915,15 @@ void simulate(vector<tuple<int, int, int>> nodePositions, int numberOfBroadcasts
         nodePointers.push_back(&node);
     }
     updateNodePointers(nodePointers);
+    linkGraph.build(nodePointers);
+
+    imageExportQueue.setOnExported([](const string& filename) {
+        cout << endl << "Image saved to " << filename << endl << ">> " << flush;
+    });
 
-    broadcastNodes(nodePointers, numberOfBroadcasts);
+    // A round with only incremental updates can be quiet while a full dump is still to come, so the tables count as
+    // converged when every node has sent a full dump without changing any route
+    broadcastUntilConverged(nodePointers, numberOfBroadcasts, fullDumpInterval);
 
     Workers worker_threads(2);
     worker_threads.start(); // Create 4 internal threads
@@ -304,6 +938,14 @@ void simulate(vector<tuple<int, int, int>> nodePositions, int numberOfBroadcasts
 
     worker_threads.stop();
 
+    if (imageExportQueue.getPendingCount() > 0) {
+        cout << "Waiting for images to be generated..." << endl;
+    }
+    imageExportQueue.stop();
+    int frames = frameRecorder.stop();
+    if (frames > 0) {
+        cout << "Recording stopped after " << frames << " frames" << endl;
+    }
 }
 
 // Nodes may share the same position, but they can't be placed inside a building.
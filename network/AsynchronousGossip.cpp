@@ -0,0 +1,158 @@
+#include "AsynchronousGossip.h"
+#include "../simulation/EventQueue.h"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <utility>
+
+/**
+ * @param broadcastInterval The average simulated time between two broadcasts of a node, in seconds.
+ * @param jitter How much each interval may be lengthened or shortened, as a fraction of the interval, from 0 to 0.9.
+ * @param seed The seed of the random times.
+ */
+AsynchronousGossip::AsynchronousGossip(double broadcastInterval, double jitter, unsigned seed)
+        : broadcastInterval(std::max(broadcastInterval, 0.001)), jitter(std::clamp(jitter, 0.0, 0.9)), seed(seed) {}
+
+/**
+ * Finds the number of hops of the shortest route between every pair of nodes. A route to a destination is learned from
+ * the broadcasts that start at the destination, so the hops from a node to a destination are the length of the
+ * shortest path of links from the destination to the node, found with a breadth first search from every destination.
+ *
+ * @param nodes Vector of pointers to the nodes, indexed by node id.
+ * @return The shortest hops at node * nodes.size() + destination, or INFINITE_HOPS where there is no route.
+ */
+std::vector<uint16_t> AsynchronousGossip::findShortestHops(const std::vector<Node*>& nodes) {
+    int count = static_cast<int>(nodes.size());
+    std::vector<std::vector<int>> receivers(count);
+    for (int node = 0; node < count; ++node) {
+        for (Node* receiver : nodes[node]->getNodesInRadius()) {
+            receivers[node].push_back(receiver->getId());
+        }
+    }
+    std::vector<uint16_t> shortestHops(static_cast<size_t>(count) * count, RouteEntry::INFINITE_HOPS);
+    std::vector<int> distances(count);
+    std::vector<int> queue;
+    for (int destination = 0; destination < count; ++destination) {
+        std::fill(distances.begin(), distances.end(), -1);
+        distances[destination] = 0;
+        queue.assign(1, destination);
+        for (size_t next = 0; next < queue.size(); ++next) {
+            int node = queue[next];
+            shortestHops[static_cast<size_t>(node) * count + destination] = static_cast<uint16_t>(distances[node]);
+            for (int receiver : receivers[node]) {
+                if (distances[receiver] < 0) {
+                    distances[receiver] = distances[node] + 1;
+                    queue.push_back(receiver);
+                }
+            }
+        }
+    }
+    return shortestHops;
+}
+
+/**
+ * Runs broadcasts at jittered times until every node knows a route to every destination it can reach and every route
+ * has been the shortest, or until the time limit. Every broadcast is an event on a virtual clock, which schedules the
+ * next broadcast of the node. For every node, the number of reachable destinations that never had a route and the
+ * number of routes that were never the shortest are counted down. Only the merges that changed routes are looked at:
+ * their changed destinations are the ones a receiver added to its list of changes during the broadcast. The first time
+ * a count reaches 0 is recorded.
+ *
+ * @param nodes Vector of pointers to the nodes, indexed by node id.
+ * @param maxTime The simulated time after which the run ends, in seconds.
+ * @return The convergence times of every node, and whether all of them converged.
+ */
+GossipResult AsynchronousGossip::run(const std::vector<Node*>& nodes, double maxTime) {
+    int count = static_cast<int>(nodes.size());
+    GossipResult result;
+    result.convergenceTimes.assign(count, -1);
+    result.shortestRouteTimes.assign(count, -1);
+
+    // The shortest hops of the routes that were never the shortest yet, and INFINITE_HOPS for the others
+    std::vector<uint16_t> pendingRoutes = findShortestHops(nodes);
+    std::vector<int> missingRoutes(count, 0), longerRoutes(count, 0);
+    int unconverged = count, notShortest = count;
+    // Counts down the routes of a node after the hops to a destination changed, or were read for the first time
+    auto checkRoute = [&](int node, int destination, uint16_t hops) {
+        uint16_t& pending = pendingRoutes[static_cast<size_t>(node) * count + destination];
+        if (pending == RouteEntry::INFINITE_HOPS) {
+            return;
+        }
+        if (hops != RouteEntry::INFINITE_HOPS && (pending & ROUTE_KNOWN) == 0) {
+            pending |= ROUTE_KNOWN;
+            missingRoutes[node]--;
+        }
+        if (hops == (pending & ~ROUTE_KNOWN)) {
+            pending = RouteEntry::INFINITE_HOPS;
+            longerRoutes[node]--;
+        }
+    };
+    auto recordTimes = [&](int node, double time) {
+        if (missingRoutes[node] == 0 && result.convergenceTimes[node] < 0) {
+            result.convergenceTimes[node] = time;
+            unconverged--;
+        }
+        if (longerRoutes[node] == 0 && result.shortestRouteTimes[node] < 0) {
+            result.shortestRouteTimes[node] = time;
+            notShortest--;
+        }
+    };
+    for (int node = 0; node < count; ++node) {
+        const RoutingTable& table = nodes[node]->getRoutingTable();
+        for (int destination = 0; destination < count; ++destination) {
+            if (pendingRoutes[static_cast<size_t>(node) * count + destination] != RouteEntry::INFINITE_HOPS) {
+                missingRoutes[node]++;
+                longerRoutes[node]++;
+                checkRoute(node, destination, table.get(destination).hops);
+            }
+        }
+        recordTimes(node, 0);
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> phase(0, broadcastInterval);
+    std::uniform_real_distribution<double> deviation(-jitter, jitter);
+    EventQueue events;
+    std::vector<size_t> changesBefore;
+    std::function<void(int, double)> scheduleBroadcast = [&](int sender, double time) {
+        events.schedule(time, [&, sender, time] {
+            result.endTime = time;
+            result.broadcasts++;
+            std::vector<Node*> receivers = nodes[sender]->getNodesInRadius();
+            changesBefore.clear();
+            for (Node* receiver : receivers) {
+                changesBefore.push_back(receiver->getChangedDestinations().size());
+            }
+            if (nodes[sender]->broadcast() > 0) {
+                for (size_t index = 0; index < receivers.size(); ++index) {
+                    Node* receiver = receivers[index];
+                    int node = receiver->getId();
+                    const std::vector<int32_t>& changed = receiver->getChangedDestinations();
+                    if (node == sender || changed.size() == changesBefore[index]) {
+                        continue;
+                    }
+                    for (size_t change = changesBefore[index]; change < changed.size(); ++change) {
+                        checkRoute(node, changed[change], receiver->getRoutingTable().get(changed[change]).hops);
+                    }
+                    recordTimes(node, time);
+                }
+            }
+            if (unconverged == 0 && notShortest == 0) {
+                events.stop();
+                return;
+            }
+            scheduleBroadcast(sender, time + broadcastInterval * (1 + deviation(rng)));
+        });
+    };
+    if (unconverged > 0 || notShortest > 0) {
+        for (int node = 0; node < count; ++node) {
+            scheduleBroadcast(node, phase(rng));
+        }
+        events.runUntil(maxTime);
+        if (unconverged > 0 || notShortest > 0) {
+            result.endTime = maxTime;
+        }
+    }
+    result.converged = unconverged == 0;
+    return result;
+}
@@ -0,0 +1,47 @@
+#ifndef ASYNCHRONOUSGOSSIP_H
+#define ASYNCHRONOUSGOSSIP_H
+
+#include "../node/Node.h"
+#include <vector>
+
+// The outcome of a gossip run. Times are in simulated seconds from the start of the run.
+struct GossipResult {
+    // Whether every node knew a route to every destination it can reach before the time limit
+    bool converged = false;
+    double endTime = 0;
+    int broadcasts = 0;
+    // The time each node first knew a route to every destination it can reach, or -1 if it never did, by node id
+    std::vector<double> convergenceTimes;
+    // The time by which every route of each node had been as short as possible at least once, or -1, by node id
+    std::vector<double> shortestRouteTimes;
+};
+
+// Simulates nodes that broadcast on their own clocks instead of in rounds. Every node broadcasts once per interval,
+// starting at a random time within the first interval, and each interval is lengthened or shortened by a random
+// jitter, so the order of the broadcasts keeps changing like it does between real radios. The random numbers come from
+// a seeded generator, so a run can be repeated. The broadcasts are events in an EventQueue, which runs them in order of
+// their simulated times, as fast as possible.
+//
+// A node has converged when it knows a route to every destination that can reach it. The run also records when every
+// route of a node has had the length of the shortest path over the links at least once. That is not always reached: a
+// route with a newer sequence number wins even if it is longer, and with incremental updates the newest sequence
+// number often comes over a longer path, so some nodes keep a longer route to a few destinations. The next hops are
+// left out of both, since they move between equally long paths.
+class AsynchronousGossip {
+private:
+    double broadcastInterval;
+    double jitter;
+    unsigned seed;
+
+    // Set in the shortest hops of a route that is followed during a run once the route had any number of hops
+    static constexpr uint16_t ROUTE_KNOWN = 0x8000;
+
+    static std::vector<uint16_t> findShortestHops(const std::vector<Node*>& nodes);
+
+public:
+    AsynchronousGossip(double broadcastInterval, double jitter, unsigned seed);
+
+    GossipResult run(const std::vector<Node*>& nodes, double maxTime);
+};
+
+#endif // ASYNCHRONOUSGOSSIP_H
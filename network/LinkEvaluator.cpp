@@ -0,0 +1,207 @@
+#include "LinkEvaluator.h"
+#include "../node/Node.h"
+#include "../topography/Topography.h"
+#include <algorithm>
+#include <limits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Coordinate differences are clamped to this, so the sum of the three squares fits in 32 bits. Nodes this far apart
+// are never in range of each other.
+const int32_t MAX_DIFFERENCE = 26754;
+const uint8_t A_REACHES_B = 1;
+const uint8_t B_REACHES_A = 2;
+
+LinkEvaluator::LinkEvaluator(Topography* topography) : topography(topography) {}
+
+/**
+ * Returns the largest squared distance where the signal of a node is strong enough to be received. The strength is
+ * signalPower / (2 * pi * distance^2), and never more than signalPower, so it is at least MIN_SIGNAL_STRENGTH when the
+ * squared distance is at most signalPower / (2 * pi * MIN_SIGNAL_STRENGTH). Squared distances are whole numbers, so the
+ * limit is rounded down.
+ *
+ * @param signalPower The signal power of the node.
+ * @return The squared range, or -1 if the signal is too weak to be received at all.
+ */
+int32_t LinkEvaluator::getRangeSquared(double signalPower) {
+    if (signalPower < Node::MIN_SIGNAL_STRENGTH) {
+        return -1;
+    }
+    double rangeSquared = std::floor(signalPower / (2.0 * M_PI * Node::MIN_SIGNAL_STRENGTH));
+    return static_cast<int32_t>(std::min(rangeSquared, static_cast<double>(std::numeric_limits<int32_t>::max())));
+}
+
+// Reads the position, squared range and power of a node, unless it was already read for this batch.
+void LinkEvaluator::readNode(const std::vector<Node*>& nodes, int node) {
+    if (nodeBatches[node] == batch) {
+        return;
+    }
+    nodeBatches[node] = batch;
+    nodeX[node] = nodes[node]->getX();
+    nodeY[node] = nodes[node]->getY();
+    nodeZ[node] = nodes[node]->getZ();
+    nodeRangesSquared[node] = getRangeSquared(nodes[node]->getSignalPower());
+    nodePowers[node] = static_cast<float>(nodes[node]->getSignalPower());
+}
+
+#if defined(__SSE2__)
+// Multiplies 32-bit lanes and keeps the low 32 bits of the products. SSE2 only multiplies every other lane.
+__m128i multiplyLow(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+#endif
+
+/**
+ * The first stage: computes the squared distances of the candidates and compares them with the squared ranges of both
+ * nodes, 4 candidates at a time with SSE2. No square roots are needed.
+ *
+ * @param begin The first candidate.
+ * @param end One past the last candidate.
+ */
+void LinkEvaluator::compareDistances(int begin, int end) {
+    int index = begin;
+#if defined(__SSE2__)
+    auto load = [](const int32_t* address) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(address));
+    };
+    for (; index + 4 <= end; index += 4) {
+        __m128i dx = load(differencesX.data() + index);
+        __m128i dy = load(differencesY.data() + index);
+        __m128i dz = load(differencesZ.data() + index);
+        __m128i distanceSquared = _mm_add_epi32(_mm_add_epi32(multiplyLow(dx, dx), multiplyLow(dy, dy)),
+                                                multiplyLow(dz, dz));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(distancesSquared.data() + index), distanceSquared);
+        int outOfRangeA = _mm_movemask_ps(_mm_castsi128_ps(
+                _mm_cmpgt_epi32(distanceSquared, load(rangesSquaredA.data() + index))));
+        int outOfRangeB = _mm_movemask_ps(_mm_castsi128_ps(
+                _mm_cmpgt_epi32(distanceSquared, load(rangesSquaredB.data() + index))));
+        for (int lane = 0; lane < 4; ++lane) {
+            inRange[index + lane] = static_cast<uint8_t>(((outOfRangeA >> lane) & 1 ? 0 : A_REACHES_B) |
+                                                         ((outOfRangeB >> lane) & 1 ? 0 : B_REACHES_A));
+        }
+    }
+#endif
+    for (; index < end; ++index) {
+        int32_t distanceSquared = differencesX[index] * differencesX[index] +
+                                  differencesY[index] * differencesY[index] +
+                                  differencesZ[index] * differencesZ[index];
+        distancesSquared[index] = distanceSquared;
+        inRange[index] = static_cast<uint8_t>((distanceSquared <= rangesSquaredA[index] ? A_REACHES_B : 0) |
+                                              (distanceSquared <= rangesSquaredB[index] ? B_REACHES_A : 0));
+    }
+}
+
+/**
+ * The second stage: computes the signal strengths of the candidates that are in range, in both directions, 4 at a
+ * time with SSE2. At distance 0 the division gives infinity, and the strength becomes the signal power.
+ *
+ * @param begin The first survivor.
+ * @param end One past the last survivor.
+ */
+void LinkEvaluator::computeStrengths(int begin, int end) {
+    const float twoPi = static_cast<float>(2.0 * M_PI);
+    int index = begin;
+#if defined(__SSE2__)
+    const __m128 twoPiLanes = _mm_set1_ps(twoPi);
+    for (; index + 4 <= end; index += 4) {
+        __m128 area = _mm_mul_ps(twoPiLanes, _mm_loadu_ps(survivorDistances.data() + index));
+        __m128 powerA = _mm_loadu_ps(survivorPowersA.data() + index);
+        __m128 powerB = _mm_loadu_ps(survivorPowersB.data() + index);
+        _mm_storeu_ps(survivorStrengthsA.data() + index, _mm_min_ps(_mm_div_ps(powerA, area), powerA));
+        _mm_storeu_ps(survivorStrengthsB.data() + index, _mm_min_ps(_mm_div_ps(powerB, area), powerB));
+    }
+#endif
+    for (; index < end; ++index) {
+        float area = twoPi * survivorDistances[index];
+        survivorStrengthsA[index] = std::min(survivorPowersA[index] / area, survivorPowersA[index]);
+        survivorStrengthsB[index] = std::min(survivorPowersB[index] / area, survivorPowersB[index]);
+    }
+}
+
+/**
+ * Evaluates a batch of candidate links. The nodes of the candidates are read once, the candidates are copied into
+ * arrays of coordinate differences and squared ranges, the pairs out of range are rejected with integer arithmetic, the
+ * strengths of the rest are computed, and the line of sight is only traced for the pairs where at least one node is in
+ * range of the other, once for both directions.
+ *
+ * @param nodes Vector of pointers to the nodes, indexed by the node indices in the candidates.
+ * @param candidates The candidate links. Their strengths are set to the result.
+ */
+void LinkEvaluator::evaluate(const std::vector<Node*>& nodes, std::vector<LinkCandidate>& candidates) {
+    if (nodeBatches.size() < nodes.size()) {
+        nodeX.resize(nodes.size());
+        nodeY.resize(nodes.size());
+        nodeZ.resize(nodes.size());
+        nodeRangesSquared.resize(nodes.size());
+        nodePowers.resize(nodes.size());
+        nodeBatches.resize(nodes.size(), batch);
+    }
+    batch++;
+
+    int count = static_cast<int>(candidates.size());
+    differencesX.resize(count);
+    differencesY.resize(count);
+    differencesZ.resize(count);
+    rangesSquaredA.resize(count);
+    rangesSquaredB.resize(count);
+    distancesSquared.resize(count);
+    inRange.resize(count);
+    auto difference = [](int from, int to) {
+        return std::clamp(to - from, -MAX_DIFFERENCE, MAX_DIFFERENCE);
+    };
+    for (int index = 0; index < count; ++index) {
+        int a = candidates[index].a;
+        int b = candidates[index].b;
+        readNode(nodes, a);
+        readNode(nodes, b);
+        differencesX[index] = difference(nodeX[a], nodeX[b]);
+        differencesY[index] = difference(nodeY[a], nodeY[b]);
+        differencesZ[index] = difference(nodeZ[a], nodeZ[b]);
+        rangesSquaredA[index] = nodeRangesSquared[a];
+        rangesSquaredB[index] = nodeRangesSquared[b];
+        candidates[index].strengthFromA = -1.0f;
+        candidates[index].strengthFromB = -1.0f;
+    }
+    compareDistances(0, count);
+
+    survivors.clear();
+    for (int index = 0; index < count; ++index) {
+        if (inRange[index] != 0) {
+            survivors.push_back(index);
+        }
+    }
+    int survivorCount = static_cast<int>(survivors.size());
+    survivorDistances.resize(survivorCount);
+    survivorPowersA.resize(survivorCount);
+    survivorPowersB.resize(survivorCount);
+    survivorStrengthsA.resize(survivorCount);
+    survivorStrengthsB.resize(survivorCount);
+    for (int survivor = 0; survivor < survivorCount; ++survivor) {
+        const LinkCandidate& candidate = candidates[survivors[survivor]];
+        survivorDistances[survivor] = static_cast<float>(distancesSquared[survivors[survivor]]);
+        survivorPowersA[survivor] = nodePowers[candidate.a];
+        survivorPowersB[survivor] = nodePowers[candidate.b];
+    }
+    computeStrengths(0, survivorCount);
+
+    for (int survivor = 0; survivor < survivorCount; ++survivor) {
+        int index = survivors[survivor];
+        LinkCandidate& candidate = candidates[index];
+        int a = candidate.a;
+        int b = candidate.b;
+        if (distancesSquared[index] > 0 &&
+            topography->isObstructionBetween(nodeX[a], nodeY[a], nodeZ[a], nodeX[b], nodeY[b], nodeZ[b])) {
+            continue;
+        }
+        if (inRange[index] & A_REACHES_B) {
+            candidate.strengthFromA = survivorStrengthsA[survivor];
+        }
+        if (inRange[index] & B_REACHES_A) {
+            candidate.strengthFromB = survivorStrengthsB[survivor];
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef LINKEVALUATOR_H
+#define LINKEVALUATOR_H
+
+#include <cstdint>
+#include <vector>
+
+class Node;
+class Topography;
+
+// A pair of nodes that may be linked. After evaluation, the strengths are the strength of the signal of each node at
+// the other, or -1 if the other node does not receive it.
+struct LinkCandidate {
+    int a;
+    int b;
+    float strengthFromA = -1.0f;
+    float strengthFromB = -1.0f;
+};
+
+// Evaluates batches of candidate links in stages, from cheap to expensive, so each stage only handles the pairs that
+// survived the previous one:
+// 1. The squared distances are compared with the squared ranges of the nodes, in integer SIMD lanes.
+// 2. The signal strengths of the pairs in range are computed in float SIMD lanes.
+// 3. The line of sight is traced for the pairs that are still left.
+class LinkEvaluator {
+private:
+    Topography* topography;
+    // The positions, squared ranges and powers of the nodes in the current batch, read once per node and batch
+    std::vector<int32_t> nodeX, nodeY, nodeZ, nodeRangesSquared;
+    std::vector<float> nodePowers;
+    std::vector<int> nodeBatches;
+    int batch = 0;
+    // The candidates in structure of arrays form, and the candidates that are in range
+    std::vector<int32_t> differencesX, differencesY, differencesZ;
+    std::vector<int32_t> rangesSquaredA, rangesSquaredB;
+    std::vector<int32_t> distancesSquared;
+    std::vector<uint8_t> inRange;
+    std::vector<int> survivors;
+    std::vector<float> survivorDistances, survivorPowersA, survivorPowersB, survivorStrengthsA, survivorStrengthsB;
+
+    void readNode(const std::vector<Node*>& nodes, int node);
+
+    void compareDistances(int begin, int end);
+
+    void computeStrengths(int begin, int end);
+
+public:
+    explicit LinkEvaluator(Topography* topography);
+
+    void evaluate(const std::vector<Node*>& nodes, std::vector<LinkCandidate>& candidates);
+
+    static int32_t getRangeSquared(double signalPower);
+};
+
+#endif // LINKEVALUATOR_H
@@ -0,0 +1,205 @@
+#include "LinkGraph.h"
+#include "../node/Node.h"
+#include <algorithm>
+
+LinkGraph::LinkGraph(Topography* topography) : evaluator(topography) {}
+
+/**
+ * Returns the radio range of a node, the largest distance where its signal strength is at least MIN_SIGNAL_STRENGTH,
+ * rounded up. The strength is signalPower / (2 * pi * distance^2), so the range is sqrt(signalPower / (2 * pi *
+ * MIN_SIGNAL_STRENGTH)).
+ *
+ * @param node Pointer to the node.
+ * @return The range of the node.
+ */
+int LinkGraph::getRange(const Node* node) {
+    return static_cast<int>(std::ceil(std::sqrt(node->getSignalPower() / (2.0 * M_PI * Node::MIN_SIGNAL_STRENGTH))));
+}
+
+// Sorts all nodes into a new grid with cells as wide as the largest range of any node.
+void LinkGraph::rebuildGrid() {
+    int cellSize = 1;
+    for (Node* node : nodes) {
+        cellSize = std::max(cellSize, getRange(node));
+    }
+    grid.reset(cellSize);
+    for (Node* node : nodes) {
+        grid.insert(node->getId(), node->getX(), node->getY());
+    }
+}
+
+void LinkGraph::markChanged(int nodeId) {
+    if (!changed[nodeId]) {
+        changed[nodeId] = true;
+        changedNodes.push_back(nodeId);
+    }
+}
+
+/**
+ * Replaces the nodes of the graph and attaches the graph to them, so they read their neighbors from it. The node ids
+ * are the indices of the nodes. The links are evaluated the first time the graph is read.
+ *
+ * @param allNodes Vector of pointers to the nodes.
+ */
+void LinkGraph::build(const std::vector<Node*>& allNodes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    nodes.assign(allNodes.size(), nullptr);
+    for (Node* node : allNodes) {
+        nodes.at(node->getId()) = node;
+        node->setLinkGraph(this);
+    }
+    offsets.assign(nodes.size() + 1, 0);
+    neighbors.clear();
+    strengths.clear();
+    changedNodes.clear();
+    changed.assign(nodes.size(), false);
+    for (int nodeId = 0; nodeId < static_cast<int>(nodes.size()); ++nodeId) {
+        markChanged(nodeId);
+    }
+    rebuildGrid();
+}
+
+/**
+ * Adds a node to the graph, and attaches the graph to it. The id of the node must be the next free id. If the node has
+ * a longer range than the cells of the grid, the grid is built again with larger cells.
+ *
+ * @param node Pointer to the new node.
+ */
+void LinkGraph::addNode(Node* node) {
+    std::lock_guard<std::mutex> lock(mutex);
+    nodes.push_back(node);
+    offsets.push_back(offsets.back());
+    changed.push_back(false);
+    markChanged(node->getId());
+    node->setLinkGraph(this);
+    if (getRange(node) > grid.getCellSize()) {
+        rebuildGrid();
+    } else {
+        grid.insert(node->getId(), node->getX(), node->getY());
+    }
+}
+
+/**
+ * Marks the links of a node as outdated after it moved, and moves it to the cell of its new position.
+ *
+ * @param nodeId The id of the node.
+ */
+void LinkGraph::invalidate(int nodeId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (nodeId >= 0 && nodeId < static_cast<int>(nodes.size())) {
+        markChanged(nodeId);
+        grid.move(nodeId, nodes[nodeId]->getX(), nodes[nodeId]->getY());
+    }
+}
+
+/**
+ * Evaluates the pairs with a changed node again, and rebuilds the arrays. Only the nodes in the cells around a changed
+ * node can be in range of it, so only those pairs are collected, and they are evaluated as one batch. The links between
+ * two nodes that did not change are copied as they are, so the cost is the evaluation of the nearby pairs plus one
+ * pass over the links.
+ */
+void LinkGraph::update() {
+    if (changedNodes.empty()) {
+        return;
+    }
+    int count = static_cast<int>(nodes.size());
+    std::vector<LinkCandidate> candidates;
+    for (int node : changedNodes) {
+        grid.forEachNear(nodes[node]->getX(), nodes[node]->getY(), [&](int other) {
+            // A pair of two changed nodes is evaluated from the one with the lower id
+            if (other != node && !(changed[other] && other < node)) {
+                candidates.push_back(LinkCandidate{node, other});
+            }
+        });
+    }
+    evaluator.evaluate(nodes, candidates);
+
+    std::vector<std::vector<std::pair<int, double>>> newLinks(count);
+    for (const LinkCandidate& candidate : candidates) {
+        if (candidate.strengthFromA >= 0) {
+            newLinks[candidate.a].emplace_back(candidate.b, candidate.strengthFromA);
+        }
+        if (candidate.strengthFromB >= 0) {
+            newLinks[candidate.b].emplace_back(candidate.a, candidate.strengthFromB);
+        }
+    }
+
+    std::vector<int> newOffsets(count + 1, 0);
+    std::vector<int> newNeighbors;
+    std::vector<double> newStrengths;
+    newNeighbors.reserve(neighbors.size());
+    newStrengths.reserve(strengths.size());
+    std::vector<std::pair<int, double>> row;
+    for (int node = 0; node < count; ++node) {
+        row.clear();
+        if (!changed[node]) {
+            for (int link = offsets[node]; link < offsets[node + 1]; ++link) {
+                if (!changed[neighbors[link]]) {
+                    row.emplace_back(neighbors[link], strengths[link]);
+                }
+            }
+        }
+        if (!newLinks[node].empty()) {
+            row.insert(row.end(), newLinks[node].begin(), newLinks[node].end());
+            std::sort(row.begin(), row.end());
+        }
+        for (const auto& [neighbor, strength] : row) {
+            newNeighbors.push_back(neighbor);
+            newStrengths.push_back(strength);
+        }
+        newOffsets[node + 1] = static_cast<int>(newNeighbors.size());
+    }
+    offsets = std::move(newOffsets);
+    neighbors = std::move(newNeighbors);
+    strengths = std::move(newStrengths);
+
+    for (int node : changedNodes) {
+        changed[node] = false;
+    }
+    changedNodes.clear();
+}
+
+/**
+ * Returns the nodes that receive the signal of a node, sorted by id.
+ *
+ * @param nodeId The id of the node.
+ * @return Vector of pointers to the neighbors.
+ */
+std::vector<Node*> LinkGraph::getNeighbors(int nodeId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    update();
+    std::vector<Node*> result;
+    if (nodeId >= 0 && nodeId < static_cast<int>(nodes.size())) {
+        result.reserve(offsets[nodeId + 1] - offsets[nodeId]);
+        for (int link = offsets[nodeId]; link < offsets[nodeId + 1]; ++link) {
+            result.push_back(nodes[neighbors[link]]);
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the nodes that receive the signal of a node, sorted by id, with the strength of the signal at each of them.
+ *
+ * @param nodeId The id of the node.
+ * @return Pairs of a neighbor and the signal strength at the neighbor.
+ */
+std::vector<std::pair<Node*, double>> LinkGraph::getLinks(int nodeId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    update();
+    std::vector<std::pair<Node*, double>> result;
+    if (nodeId >= 0 && nodeId < static_cast<int>(nodes.size())) {
+        result.reserve(offsets[nodeId + 1] - offsets[nodeId]);
+        for (int link = offsets[nodeId]; link < offsets[nodeId + 1]; ++link) {
+            result.emplace_back(nodes[neighbors[link]], strengths[link]);
+        }
+    }
+    return result;
+}
+
+// Returns the number of links, counting both directions of a link separately.
+int LinkGraph::getLinkCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    update();
+    return static_cast<int>(neighbors.size());
+}
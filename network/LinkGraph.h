@@ -0,0 +1,55 @@
+#ifndef LINKGRAPH_H
+#define LINKGRAPH_H
+
+#include "LinkEvaluator.h"
+#include "SpatialGrid.h"
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class Node;
+class Topography;
+
+// The radio links between the nodes, in compressed sparse row form: the links of the node with id i are at offsets[i]
+// to offsets[i + 1] in the neighbor and strength arrays, sorted by the id of the neighbor. The links are evaluated
+// once and kept until a node moves or is added, and then only the pairs with that node are evaluated again. The
+// graph is updated the next time it is read. The candidates for the links of a node are found in a spatial grid with
+// cells as wide as the largest radio range, and evaluated in batches by a LinkEvaluator.
+class LinkGraph {
+private:
+    LinkEvaluator evaluator;
+    std::vector<Node*> nodes;
+    std::vector<int> offsets;
+    std::vector<int> neighbors;
+    std::vector<double> strengths;
+    SpatialGrid grid;
+    // The nodes whose links have to be evaluated again
+    std::vector<int> changedNodes;
+    std::vector<bool> changed;
+    std::mutex mutex;
+
+    void markChanged(int nodeId);
+
+    void rebuildGrid();
+
+    void update();
+
+public:
+    explicit LinkGraph(Topography* topography);
+
+    void build(const std::vector<Node*>& allNodes);
+
+    void addNode(Node* node);
+
+    void invalidate(int nodeId);
+
+    std::vector<Node*> getNeighbors(int nodeId);
+
+    std::vector<std::pair<Node*, double>> getLinks(int nodeId);
+
+    int getLinkCount();
+
+    static int getRange(const Node* node);
+};
+
+#endif // LINKGRAPH_H
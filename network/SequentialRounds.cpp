@@ -0,0 +1,64 @@
+#include "SequentialRounds.h"
+#include <algorithm>
+
+SequentialRounds::SequentialRounds(BroadcastOrder order) : order(order) {}
+
+void SequentialRounds::setOrder(BroadcastOrder newOrder) {
+    order = newOrder;
+    round = 0;
+}
+
+BroadcastOrder SequentialRounds::getOrder() const {
+    return order;
+}
+
+/**
+ * Orders the nodes breadth first over the links. The search starts from the node with the lowest id, and again from
+ * the lowest id that was not reached whenever a search ends, so every node is scheduled once. The links are read again
+ * every round, so the order follows the nodes when they move.
+ *
+ * @param nodes Vector of pointers to the nodes, indexed by node id.
+ */
+void SequentialRounds::scheduleWavefronts(const std::vector<Node*>& nodes) {
+    int count = static_cast<int>(nodes.size());
+    std::vector<bool> scheduled(count, false);
+    schedule.clear();
+    for (int start = 0; start < count; ++start) {
+        if (scheduled[start]) {
+            continue;
+        }
+        scheduled[start] = true;
+        schedule.push_back(nodes[start]);
+        for (size_t next = schedule.size() - 1; next < schedule.size(); ++next) {
+            for (Node* neighbor : schedule[next]->getNodesInRadius()) {
+                if (!scheduled[neighbor->getId()]) {
+                    scheduled[neighbor->getId()] = true;
+                    schedule.push_back(neighbor);
+                }
+            }
+        }
+    }
+    if (round % 2 == 1) {
+        std::reverse(schedule.begin(), schedule.end());
+    }
+}
+
+/**
+ * Runs one round where every node broadcasts once, in the chosen order.
+ *
+ * @param nodes Vector of pointers to the nodes, indexed by node id.
+ * @return The number of routes that changed in the round.
+ */
+int SequentialRounds::runRound(const std::vector<Node*>& nodes) {
+    if (order == BroadcastOrder::WAVEFRONT) {
+        scheduleWavefronts(nodes);
+    } else {
+        schedule = nodes;
+    }
+    round++;
+    int changes = 0;
+    for (Node* node : schedule) {
+        changes += node->broadcast();
+    }
+    return changes;
+}
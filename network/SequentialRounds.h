@@ -0,0 +1,36 @@
+#ifndef SEQUENTIALROUNDS_H
+#define SEQUENTIALROUNDS_H
+
+#include "../node/Node.h"
+#include <vector>
+
+// The order in which the nodes broadcast in a sequential round
+enum class BroadcastOrder {
+    ID,
+    WAVEFRONT
+};
+
+// Runs broadcast rounds where the nodes broadcast one by one. A node passes on what it received earlier in the same
+// round, so a route crosses the network in a single round when the nodes along it broadcast in the order the route
+// runs. In id order that only happens by chance. In wavefront order the nodes are visited breadth first over the
+// links, starting from the lowest id in every part of the network, so routes from the start of the search travel
+// outwards in one round. Every other round the order is reversed, so routes towards the start travel back as fast.
+class SequentialRounds {
+private:
+    BroadcastOrder order;
+    int round = 0;
+    std::vector<Node*> schedule;
+
+    void scheduleWavefronts(const std::vector<Node*>& nodes);
+
+public:
+    explicit SequentialRounds(BroadcastOrder order);
+
+    void setOrder(BroadcastOrder newOrder);
+
+    BroadcastOrder getOrder() const;
+
+    int runRound(const std::vector<Node*>& nodes);
+};
+
+#endif // SEQUENTIALROUNDS_H
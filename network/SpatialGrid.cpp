@@ -0,0 +1,65 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+
+/**
+ * Empties the grid and sets the width of the cells.
+ *
+ * @param size The width and height of a cell. Sizes below 1 are raised to 1.
+ */
+void SpatialGrid::reset(int size) {
+    cellSize = std::max(size, 1);
+    cells.clear();
+    nodeCells.clear();
+}
+
+/**
+ * Adds a node to the cell of its position. A node that is already in the grid is moved instead.
+ *
+ * @param nodeId The id of the node.
+ * @param x The x position of the node.
+ * @param y The y position of the node.
+ */
+void SpatialGrid::insert(int nodeId, int x, int y) {
+    if (nodeId >= static_cast<int>(nodeCells.size())) {
+        nodeCells.resize(nodeId + 1, NO_CELL);
+    }
+    removeFromCell(nodeId);
+    long long key = cellKey(cellCoordinate(x), cellCoordinate(y));
+    cells[key].push_back(nodeId);
+    nodeCells[nodeId] = key;
+}
+
+/**
+ * Moves a node to the cell of its new position. Only the old and the new cell are touched, and nothing changes if the
+ * node stays in the same cell.
+ *
+ * @param nodeId The id of the node.
+ * @param x The new x position of the node.
+ * @param y The new y position of the node.
+ */
+void SpatialGrid::move(int nodeId, int x, int y) {
+    if (nodeId < static_cast<int>(nodeCells.size()) &&
+        nodeCells[nodeId] == cellKey(cellCoordinate(x), cellCoordinate(y))) {
+        return;
+    }
+    insert(nodeId, x, y);
+}
+
+void SpatialGrid::removeFromCell(int nodeId) {
+    if (nodeCells[nodeId] == NO_CELL) {
+        return;
+    }
+    auto cell = cells.find(nodeCells[nodeId]);
+    if (cell != cells.end()) {
+        std::vector<int>& ids = cell->second;
+        ids.erase(std::find(ids.begin(), ids.end(), nodeId));
+        if (ids.empty()) {
+            cells.erase(cell);
+        }
+    }
+    nodeCells[nodeId] = NO_CELL;
+}
+
+int SpatialGrid::getCellSize() const {
+    return cellSize;
+}
@@ -0,0 +1,64 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+// A spatial hash of node positions in square cells. With cells as wide as the largest radio range, every node that is
+// in range of a node lies in the cell of the node or in one of the 8 cells around it.
+class SpatialGrid {
+private:
+    int cellSize = 1;
+    std::unordered_map<long long, std::vector<int>> cells;
+    // The key of the cell of every node id, or NO_CELL for nodes that are not in the grid
+    std::vector<long long> nodeCells;
+
+    int cellCoordinate(int position) const;
+
+    static long long cellKey(int cellX, int cellY);
+
+    void removeFromCell(int nodeId);
+
+public:
+    static constexpr long long NO_CELL = std::numeric_limits<long long>::min();
+
+    void reset(int size);
+
+    void insert(int nodeId, int x, int y);
+
+    void move(int nodeId, int x, int y);
+
+    int getCellSize() const;
+
+    template<typename Function>
+    void forEachNear(int x, int y, Function function) const;
+};
+
+inline int SpatialGrid::cellCoordinate(int position) const {
+    return position >= 0 ? position / cellSize : (position - cellSize + 1) / cellSize;
+}
+
+inline long long SpatialGrid::cellKey(int cellX, int cellY) {
+    return static_cast<long long>((static_cast<unsigned long long>(static_cast<unsigned int>(cellX)) << 32) |
+                                  static_cast<unsigned int>(cellY));
+}
+
+// Calls function(nodeId) for every node in the cell of (x, y) and in the 8 cells around it
+template<typename Function>
+void SpatialGrid::forEachNear(int x, int y, Function function) const {
+    int cellX = cellCoordinate(x);
+    int cellY = cellCoordinate(y);
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            auto cell = cells.find(cellKey(cellX + dx, cellY + dy));
+            if (cell != cells.end()) {
+                for (int nodeId : cell->second) {
+                    function(nodeId);
+                }
+            }
+        }
+    }
+}
+
+#endif // SPATIALGRID_H
@@ -0,0 +1,104 @@
+#include "SynchronousRounds.h"
+#include "../worker/Workers.h"
+#include <algorithm>
+
+SynchronousRounds::SynchronousRounds(int numberOfThreads) : numberOfThreads(std::max(numberOfThreads, 1)) {}
+
+SynchronousRounds::~SynchronousRounds() {
+    if (workers) {
+        workers->stop();
+    }
+}
+
+/**
+ * Finds the nodes whose signal each node receives. The nodes know who receives their own signal, so the lists are
+ * turned around. The senders of every node end up sorted by id, since the nodes are visited in id order.
+ *
+ * @param nodes Vector of pointers to the nodes, indexed by node id.
+ */
+void SynchronousRounds::collectSenders(const std::vector<Node*>& nodes) {
+    int count = static_cast<int>(nodes.size());
+    std::vector<std::vector<Node*>> receivers(count);
+    senderOffsets.assign(count + 2, 0);
+    for (int node = 0; node < count; ++node) {
+        receivers[node] = nodes[node]->getNodesInRadius();
+        for (Node* receiver : receivers[node]) {
+            senderOffsets[receiver->getId() + 2]++;
+        }
+    }
+    for (int node = 0; node < count; ++node) {
+        senderOffsets[node + 2] += senderOffsets[node + 1];
+    }
+    senders.resize(senderOffsets[count + 1]);
+    for (int node = 0; node < count; ++node) {
+        for (Node* receiver : receivers[node]) {
+            senders[senderOffsets[receiver->getId() + 1]++] = node;
+        }
+    }
+    senderOffsets.pop_back();
+}
+
+/**
+ * Runs one round where every node broadcasts its full routing table. First every node advances the sequence number of
+ * its own route, as a broadcast does. Then the new table of every node is built from its own table and the tables of
+ * the nodes it receives, in id order of the senders. The nodes are divided between the threads, each thread counts its
+ * changes separately, and the new tables are swapped in after all threads are done. The threads are kept from one
+ * round to the next, so a round does not pay for starting them.
+ *
+ * @param nodes Vector of pointers to the nodes, indexed by node id.
+ * @return The number of routes that changed in the round.
+ */
+int SynchronousRounds::runRound(const std::vector<Node*>& nodes) {
+    int count = static_cast<int>(nodes.size());
+    if (count == 0) {
+        return 0;
+    }
+    collectSenders(nodes);
+    for (Node* node : nodes) {
+        node->advanceSequenceNumber();
+    }
+    nextTables.resize(count);
+    changedDestinations.resize(count);
+    if (!workers) {
+        workers = std::make_unique<Workers>(numberOfThreads);
+        workers->start();
+    }
+
+    int threads = std::min(numberOfThreads, count);
+    std::vector<int> changes(threads, 0);
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        unfinishedTasks = threads;
+    }
+    for (int thread = 0; thread < threads; ++thread) {
+        workers->post([this, &nodes, &changes, threads, thread] {
+            for (int node = thread; node < static_cast<int>(nodes.size()); node += threads) {
+                RoutingTable& table = nextTables[node];
+                table = nodes[node]->getRoutingTable();
+                for (int sender = senderOffsets[node]; sender < senderOffsets[node + 1]; ++sender) {
+                    changes[thread] += table.merge(nodes[senders[sender]]->getRoutingTable(), senders[sender],
+                                                   node, &changedDestinations[node]);
+                }
+            }
+            std::lock_guard<std::mutex> lock(tasksMutex);
+            if (--unfinishedTasks == 0) {
+                tasksDone.notify_one();
+            }
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(tasksMutex);
+        tasksDone.wait(lock, [this] {
+            return unfinishedTasks == 0;
+        });
+    }
+
+    for (int node = 0; node < count; ++node) {
+        nodes[node]->swapRoutingTable(nextTables[node], changedDestinations[node]);
+    }
+    int totalChanges = 0;
+    for (int threadChanges : changes) {
+        totalChanges += threadChanges;
+    }
+    return totalChanges;
+}
@@ -0,0 +1,44 @@
+#ifndef SYNCHRONOUSROUNDS_H
+#define SYNCHRONOUSROUNDS_H
+
+#include "../node/Node.h"
+#include "../worker/Workers.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Runs broadcast rounds where every node broadcasts at the same time. Each node builds its table for the next round
+// from its own table and the tables its neighbors had at the end of the previous round, which are only read, so the
+// nodes can be divided between threads without locks. The tables are double-buffered: the next tables are built in
+// separate buffers and swapped into the nodes when every node is done. The result of a round does not depend on the
+// order of the nodes or the number of threads.
+class SynchronousRounds {
+private:
+    int numberOfThreads;
+    // The tables of the next round, indexed by node id. After the swap they hold the old tables, whose memory is
+    // reused in the next round.
+    std::vector<RoutingTable> nextTables;
+    // The destinations that changed in the next table of every node
+    std::vector<std::vector<int32_t>> changedDestinations;
+    // The nodes whose signal each node receives, in compressed sparse row form, sorted by id
+    std::vector<int> senderOffsets;
+    std::vector<int> senders;
+    // The threads are started with the first round and kept for the following rounds. Every round waits until the
+    // threads have finished all of its tasks.
+    std::unique_ptr<Workers> workers;
+    std::mutex tasksMutex;
+    std::condition_variable tasksDone;
+    int unfinishedTasks = 0;
+
+    void collectSenders(const std::vector<Node*>& nodes);
+
+public:
+    explicit SynchronousRounds(int numberOfThreads);
+
+    ~SynchronousRounds();
+
+    int runRound(const std::vector<Node*>& nodes);
+};
+
+#endif // SYNCHRONOUSROUNDS_H
@@ -1,9 +1,11 @@
 #include "Node.h"
 #include "../topography/Topography.h"
+#include "../network/LinkGraph.h"
+#include <algorithm>
 
 Node::Node(int nodeId, int xPos, int yPos, int zPos, double power, Topography* topography)
         : id(nodeId), x(xPos), y(yPos), z(zPos), signalPower(power), topography(topography) {
-    routingTable[id] = std::make_tuple(id, 0, 0);
+    routingTable.set(id, RouteEntry{id, 0, 0});
 }
 
 int Node::getId() const {
@@ -14,20 +16,170 @@ void Node::setPosition(int xPos, int yPos, int zPos) {
     x = xPos;
     y = yPos;
     z = zPos;
+    if (linkGraph != nullptr) {
+        linkGraph->invalidate(id);
+    }
+}
+
+
+// Sets how many broadcasts there are between the full dumps of the routing table. 1 sends the full table every time.
+void Node::setFullDumpInterval(int broadcasts) {
+    fullDumpInterval = std::max(broadcasts, 1);
+    broadcastsSinceFullDump = 0;
 }
 
+int Node::getFullDumpInterval() const {
+    return fullDumpInterval;
+}
+
+// Sets the seconds between the broadcasts of the node, for when the nodes broadcast on their own timers.
+void Node::setBroadcastInterval(double seconds) {
+    broadcastInterval = std::max(seconds, 0.1);
+}
 
-// This method sends routing table information to other nodes in range to updateNodePointers the other nodes.
-void Node::broadcast() {
-    this->routingTable[id] = std::make_tuple(id, std::get<1>(routingTable[id]), std::get<2>(routingTable[id]) + 2);
+double Node::getBroadcastInterval() const {
+    return broadcastInterval;
+}
+
+// This method sends routing table information to other nodes in range to updateNodePointers the other nodes. Returns the
+// number of routes that changed in the tables of the neighbors.
+// As in DSDV, the whole table is only sent every fullDumpInterval broadcasts. The broadcasts in between are incremental
+// updates with the own route and the routes that changed since the previous broadcast. Routes that only got a newer
+// sequence number are left for the next full dump, so the size of the updates follows how much the network changes
+// instead of its size. Neighbors that come into range miss the earlier updates, and catch up at the next full dump.
+int Node::broadcast() {
+    advanceSequenceNumber();
+
+    bool fullDump = broadcastsSinceFullDump == 0;
+    broadcastsSinceFullDump = (broadcastsSinceFullDump + 1) % fullDumpInterval;
+    std::vector<RouteUpdate> updates;
+    if (!fullDump) {
+        changedDestinations.push_back(id);
+        updates = takeChangedRoutes();
+    }
+    changedDestinations.clear();
+    significantChanges = 0;
+
+    int changes = 0;
     for(Node* node : getNodesInRadius()) {
         if(node->id != this->id) { // Do not send to self
-            sendRoutingTable(*node);
+            changes += fullDump ? sendRoutingTable(*node) : sendRoutingUpdates(*node, updates);
+        }
+    }
+    return changes;
+}
+
+// Sends a triggered update, as DSDV does when routes appear or break between the regular broadcasts: the routes that
+// changed since the previous broadcast, without a new sequence number for the own route. A triggered update does not
+// count towards the next full dump. Returns the number of routes that changed in the tables of the neighbors.
+int Node::broadcastChanges() {
+    std::vector<RouteUpdate> updates = takeChangedRoutes();
+    significantChanges = 0;
+    int changes = 0;
+    if (updates.empty()) {
+        return changes;
+    }
+    for (Node* node : getNodesInRadius()) {
+        if (node->id != this->id) {
+            changes += sendRoutingUpdates(*node, updates);
         }
     }
+    return changes;
+}
+
+// Returns the number of destinations that became reachable or unreachable since the last broadcast of the node.
+int Node::getSignificantChanges() const {
+    return significantChanges;
+}
+
+// Returns the current routes to the destinations that changed since the last broadcast, sorted by destination, and
+// empties the list of changed destinations.
+std::vector<RouteUpdate> Node::takeChangedRoutes() {
+    std::sort(changedDestinations.begin(), changedDestinations.end());
+    changedDestinations.erase(std::unique(changedDestinations.begin(), changedDestinations.end()),
+                              changedDestinations.end());
+    std::vector<RouteUpdate> updates;
+    updates.reserve(changedDestinations.size());
+    for (int32_t destination : changedDestinations) {
+        updates.push_back(RouteUpdate{destination, routingTable.get(destination)});
+    }
+    changedDestinations.clear();
+    return updates;
 }
 
+// Rebuilds the reachable destinations from the routing table, if the table was replaced since they were last known.
+void Node::updateReachable() {
+    if (!reachableOutdated) {
+        return;
+    }
+    reachable.assign(reachable.size(), false);
+    routingTable.forEach([this](int destination, const RouteEntry& entry) {
+        if (destination >= static_cast<int>(reachable.size())) {
+            reachable.resize(destination + 1, false);
+        }
+        reachable[destination] = entry.hops != RouteEntry::INFINITE_HOPS;
+    });
+    reachableOutdated = false;
+}
+
+// Counts the destinations that changed from firstChange on in changedDestinations, and that became reachable or
+// unreachable. Only the changed destinations are looked at, so the cost follows the number of changes.
+void Node::countSignificantChanges(size_t firstChange) {
+    for (size_t change = firstChange; change < changedDestinations.size(); ++change) {
+        int32_t destination = changedDestinations[change];
+        bool isReachable = routingTable.get(destination).hops != RouteEntry::INFINITE_HOPS;
+        if (destination >= static_cast<int32_t>(reachable.size())) {
+            reachable.resize(destination + 1, false);
+        }
+        if (reachable[destination] != isReachable) {
+            reachable[destination] = isReachable;
+            significantChanges++;
+        }
+    }
+}
+
+// Increases the sequence number of the node's own route to the next even number, as every broadcast does. Even numbers
+// are used for routes that are not broken. The own route always leads to the node itself in 0 hops.
+void Node::advanceSequenceNumber() {
+    RouteEntry ownEntry = routingTable.get(id);
+    this->routingTable.set(id, RouteEntry{id, 0, (ownEntry.sequenceNumber | 1) + 1});
+}
+
+// Exchanges the routing table of the node with another table, and the destinations that changed since the last
+// broadcast with the ones that changed in the new table. The node sent its full table in the round, so only the new
+// changes are left for the next incremental update. Used to switch the buffers of synchronous rounds.
+void Node::swapRoutingTable(RoutingTable& table, std::vector<int32_t>& changed) {
+    std::swap(routingTable, table);
+    std::swap(changedDestinations, changed);
+    changed.clear();
+    reachableOutdated = true;
+}
+
+// Forgets every learned route, so the node only knows itself, as when it was created. The next broadcast is a full dump.
+void Node::resetRoutingTable() {
+    routingTable = RoutingTable();
+    routingTable.set(id, RouteEntry{id, 0, 0});
+    changedDestinations.clear();
+    broadcastsSinceFullDump = 0;
+    reachableOutdated = true;
+    significantChanges = 0;
+}
+
+// Marks the routes through a neighbor as broken, when nothing was heard from it for too long. The broken routes are
+// sent with the next incremental update, so the neighbors learn about the break. Returns the number of broken routes.
+int Node::expireRoutesThrough(int neighborId) {
+    updateReachable();
+    size_t firstChange = changedDestinations.size();
+    int expired = routingTable.expireRoutesThrough(neighborId, &changedDestinations);
+    countSignificantChanges(firstChange);
+    return expired;
+}
+
+// Returns the nodes that receive the signal of this node. They are read from the link graph when the node has one.
 std::vector<Node*> Node::getNodesInRadius() {
+    if (linkGraph != nullptr) {
+        return linkGraph->getNeighbors(id);
+    }
     std::vector<Node*> nodesInRadius;
     bool noNodesInRange = true;
     for (Node* otherNode : allNodes) {
@@ -53,35 +205,34 @@ void Node::updateOwnTableFromAllInRange() {
     }
 }
 
-void Node::updateRoutingTable(const RoutingTable& tableB, int neighborId) {
-    RoutingTable tableA = this->routingTable;
-    for (const auto& [destination, entryB] : tableB) {
-        int nextHopB, numHopsB, seqNumberB;
-        std::tie(nextHopB, numHopsB, seqNumberB) = entryB;
+// Merges the routing table of a neighbor into this node's table, in place. Returns the number of routes that changed.
+int Node::updateRoutingTable(const RoutingTable& tableB, int neighborId) {
+    updateReachable();
+    size_t firstChange = changedDestinations.size();
+    int changes = routingTable.merge(tableB, neighborId, id, &changedDestinations);
+    countSignificantChanges(firstChange);
+    return changes;
+}
 
-        if (tableA.find(destination) == tableA.end()) {  // If the destination does not exist in A's table, add it
-            tableA[destination] = std::make_tuple(neighborId, numHopsB + 1, seqNumberB);
-        }
-        else {  // If the destination exists, updateNodePointers it based on DSDV conditions
-            auto& [_, numHopsA, seqNumberA] = tableA[destination];
+// Merges an incremental update from a neighbor into this node's table. Returns the number of routes that changed.
+int Node::receiveRoutingUpdates(const std::vector<RouteUpdate>& updates, int neighborId) {
+    updateReachable();
+    size_t firstChange = changedDestinations.size();
+    int changes = routingTable.merge(updates, neighborId, id, &changedDestinations);
+    countSignificantChanges(firstChange);
+    return changes;
+}
 
-            if (seqNumberB > seqNumberA) {
-                tableA[destination] = std::make_tuple(neighborId, numHopsB + 1, seqNumberB);
-            }
-            else if (seqNumberB == seqNumberA && numHopsB + 1 < numHopsA) {
-                tableA[destination] = std::make_tuple(neighborId, numHopsB + 1, seqNumberB);
-            }
-        }
-    }
-    this->routingTable = tableA;
+int Node::receiveRoutingTable(RoutingTable& receivedTable, int neighborId) {
+    return updateRoutingTable(receivedTable, neighborId);
 }
 
-void Node::receiveRoutingTable(RoutingTable& receivedTable, int neighborId) {
-    updateRoutingTable(receivedTable, neighborId);
+int Node::sendRoutingTable(Node& neighbor) {
+    return neighbor.receiveRoutingTable(routingTable, id);
 }
 
-void Node::sendRoutingTable(Node& neighbor) {
-    neighbor.receiveRoutingTable(routingTable, id);
+int Node::sendRoutingUpdates(Node& neighbor, const std::vector<RouteUpdate>& updates) {
+    return neighbor.receiveRoutingUpdates(updates, id);
 }
 
 double Node::calculateSignalStrength(Node* node) {
@@ -89,16 +240,19 @@ double Node::calculateSignalStrength(Node* node) {
 }
 
 double Node::calculateSignalStrength(int destX, int destY, int destZ) {
-    if(topography->isObstructionBetween(x, y, z, destX, destY, destZ))
-        return -1.0;
-    double distance = std::sqrt(std::pow(x - destX, 2) + std::pow(y - destY, 2) + std::pow(z - destZ, 2));
-    if(distance == 0) return signalPower;
-    double signalStrength = signalPower / (2.0 * M_PI * distance * distance);
+    double dx = x - destX;
+    double dy = y - destY;
+    double dz = z - destZ;
+    double distanceSquared = dx * dx + dy * dy + dz * dz;
+    if(distanceSquared == 0) return signalPower;
+    double signalStrength = signalPower / (2.0 * M_PI * distanceSquared);
 
-    // Check if the signal strength is too low
+    // Check if the signal strength is too low before the line of sight, which is much more expensive to check
     if (signalStrength < MIN_SIGNAL_STRENGTH) {
         return -1.0; // Return -1 indicating a weak signal
     }
+    if(topography->isObstructionBetween(x, y, z, destX, destY, destZ))
+        return -1.0;
     if(signalStrength > signalPower) {
         return signalPower;
     }
@@ -110,19 +264,32 @@ double Node::calculateSignalStrength(int destX, int destY, int destZ) {
 
 void Node::printRoutingTable() const {
     std::cout << "Routing Table for Node " << id << ":" << std::endl;
-    for (const auto& entry : routingTable) {
-        std::cout << "Destination: " << entry.first;
-        std::cout << ", Next Hop: " << std::get<0>(entry.second);
-        std::cout << ", Number of hops: " << std::get<1>(entry.second);
-        std::cout << ", Sequence Number: " << std::get<2>(entry.second) << std::endl;
-    }
+    routingTable.forEach([](int destination, const RouteEntry& entry) {
+        std::cout << "Destination: " << destination;
+        std::cout << ", Next Hop: " << entry.nextHop;
+        std::cout << ", Number of hops: " << entry.hops;
+        std::cout << ", Sequence Number: " << entry.sequenceNumber << std::endl;
+    });
     std::cout << std::endl;
 }
 
+const RoutingTable& Node::getRoutingTable() const {
+    return routingTable;
+}
+
+// Returns the destinations whose route changed since the last broadcast of the node, in the order they changed
+const std::vector<int32_t>& Node::getChangedDestinations() const {
+    return changedDestinations;
+}
+
 void Node::updateAllNodes(std::vector<Node*> &allNodes) {
     this->allNodes = allNodes;
 }
 
+void Node::setLinkGraph(LinkGraph* graph) {
+    linkGraph = graph;
+}
+
 double Node::getSignalPower() const {
     return signalPower;
 }
@@ -141,11 +308,11 @@ int Node::getX() const {
 
 void Node::sendMessage(int receiverId, std::string basicString, std::vector<std::pair<Node*, Node*>>& connectedDrones) {
 
-    if(routingTable.find(receiverId) == routingTable.end()) {
+    if(!routingTable.contains(receiverId) || routingTable.get(receiverId).hops == RouteEntry::INFINITE_HOPS) {
         std::cout << "Node " << id << " does not have a route to node " << receiverId << std::endl;
         return;
     }
-    int nextNode = std::get<0>(routingTable[receiverId]);
+    int nextNode = routingTable.get(receiverId).nextHop;
     connectedDrones.emplace_back(this, allNodes[nextNode]);
     if(nextNode == id) {
         std::cout << "Message received by node " << id << ": " << basicString << std::endl;
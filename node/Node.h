@@ -8,10 +8,10 @@
 #include <cmath>
 #include <map>
 #include <tuple>
+#include "../routing/RoutingTable.h"
 
 class Topography;
-
-using RoutingTable = std::map<int, std::tuple<int, double, int>>;
+class LinkGraph;
 
 class Node {
 private:
@@ -21,12 +21,37 @@ private:
     int y;
     int z;
     double signalPower;
-    const double MIN_SIGNAL_STRENGTH = 0.02;
     RoutingTable routingTable;
+    // Every fullDumpInterval broadcasts the whole table is sent, and in between only the changed routes
+    int fullDumpInterval = DEFAULT_FULL_DUMP_INTERVAL;
+    int broadcastsSinceFullDump = 0;
+    // The seconds between the broadcasts of the node when every node broadcasts on its own timer
+    double broadcastInterval = DEFAULT_BROADCAST_INTERVAL;
+    // The destinations whose next hop or number of hops changed since the last broadcast
+    std::vector<int32_t> changedDestinations;
+    // Whether the node has a route with a finite number of hops to each destination, by id. Rebuilt from the table
+    // before the next change after the table was replaced as a whole.
+    std::vector<bool> reachable;
+    bool reachableOutdated = true;
+    // The number of destinations that became reachable or unreachable since the last broadcast
+    int significantChanges = 0;
     std::vector<Node*> allNodes;
     Topography* topography;
+    // When set, the neighbors are read from the link graph instead of being searched for
+    LinkGraph* linkGraph = nullptr;
+
+    std::vector<RouteUpdate> takeChangedRoutes();
+
+    void updateReachable();
+
+    void countSignificantChanges(size_t firstChange);
 
 public:
+    // The weakest signal that still counts as a link
+    static constexpr double MIN_SIGNAL_STRENGTH = 0.02;
+    static const int DEFAULT_FULL_DUMP_INTERVAL = 10;
+    static constexpr double DEFAULT_BROADCAST_INTERVAL = 5.0;
+
     Node(int nodeId, int xPos, int yPos, int zPos, double power, Topography* topography);
 
     int getX() const;
@@ -37,23 +62,45 @@ public:
 
     double getSignalPower() const;
 
-    void sendRoutingTable(Node& neighbor);
+    int sendRoutingTable(Node& neighbor);
+
+    int sendRoutingUpdates(Node& neighbor, const std::vector<RouteUpdate>& updates);
 
     double calculateSignalStrength(int destX, int destY, int destZ);
 
     void printRoutingTable() const;
 
-    void broadcast();
+    const RoutingTable& getRoutingTable() const;
+
+    const std::vector<int32_t>& getChangedDestinations() const;
+
+    int broadcast();
+
+    int broadcastChanges();
+
+    int getSignificantChanges() const;
+
+    void advanceSequenceNumber();
+
+    void swapRoutingTable(RoutingTable& table, std::vector<int32_t>& changed);
+
+    void resetRoutingTable();
+
+    int expireRoutesThrough(int neighborId);
 
     std::vector<Node *> getNodesInRadius();
 
     void updateAllNodes(std::vector<Node*> &allNodes);
 
-    void receiveRoutingTable(RoutingTable& receivedTable, int neighborId);
+    void setLinkGraph(LinkGraph* graph);
+
+    int receiveRoutingTable(RoutingTable& receivedTable, int neighborId);
+
+    int receiveRoutingUpdates(const std::vector<RouteUpdate>& updates, int neighborId);
 
     void updateOwnTableFromAllInRange();
 
-    void updateRoutingTable(const RoutingTable &tableB, int neighborId);
+    int updateRoutingTable(const RoutingTable &tableB, int neighborId);
 
     double calculateSignalStrength(Node *node);
 
@@ -61,6 +108,14 @@ public:
 
     void setPosition(int xPos, int yPos, int zPos);
 
+    void setFullDumpInterval(int broadcasts);
+
+    int getFullDumpInterval() const;
+
+    void setBroadcastInterval(double seconds);
+
+    double getBroadcastInterval() const;
+
     void sendMessage(int receiverId, std::string basicString, std::vector<std::pair<Node*, Node*>>& connectedDrones);
 };
 
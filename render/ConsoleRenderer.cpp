@@ -0,0 +1,159 @@
+#include "ConsoleRenderer.h"
+
+/**
+ * Appends the SGR sequences needed to switch to the colors of the given cell. Nothing is appended for a color that
+ * is already active, so runs of identically colored cells only pay for their glyphs.
+ *
+ * @param cell The cell that is about to be drawn.
+ */
+void ConsoleRenderer::appendColors(const ConsoleCell& cell) {
+    if (cell.foreground != currentForeground) {
+        if (cell.foreground == DEFAULT_COLOR) {
+            buffer += "\033[39m";
+        } else {
+            buffer += "\033[38;2;";
+            buffer += std::to_string((cell.foreground >> 16) & 0xFF) + ";";
+            buffer += std::to_string((cell.foreground >> 8) & 0xFF) + ";";
+            buffer += std::to_string(cell.foreground & 0xFF) + "m";
+        }
+        currentForeground = cell.foreground;
+    }
+    if (cell.background != currentBackground) {
+        if (cell.background == DEFAULT_COLOR) {
+            buffer += "\033[49m";
+        } else {
+            buffer += "\033[48;2;";
+            buffer += std::to_string((cell.background >> 16) & 0xFF) + ";";
+            buffer += std::to_string((cell.background >> 8) & 0xFF) + ";";
+            buffer += std::to_string(cell.background & 0xFF) + "m";
+        }
+        currentBackground = cell.background;
+    }
+}
+
+/**
+ * Appends the glyph of a cell. Cells without a glyph are drawn with the UTF-8 upper half block.
+ *
+ * @param cell The cell to draw.
+ */
+void ConsoleRenderer::appendGlyph(const ConsoleCell& cell) {
+    if (cell.glyph == 0) {
+        buffer += "\xE2\x96\x80";
+    } else {
+        buffer += cell.glyph;
+    }
+}
+
+/**
+ * Appends an absolute cursor movement. Rows and columns are zero based, relative to the top left of the terminal.
+ *
+ * @param row The row to move to.
+ * @param column The column to move to.
+ */
+void ConsoleRenderer::appendCursorPosition(int row, int column) {
+    buffer += "\033[" + std::to_string(row + 1) + ";" + std::to_string(column + 1) + "H";
+}
+
+/**
+ * Appends every cell of a frame. An anchored frame is drawn from the top left corner of the terminal so later frames
+ * can be patched in place, otherwise it is drawn at the current cursor position.
+ *
+ * @param cells The cells of the frame in row-major order.
+ * @param width The width of the frame in cells.
+ * @param height The height of the frame in cells.
+ * @param anchored Whether the frame is drawn at the top left corner of the terminal.
+ */
+void ConsoleRenderer::appendFullFrame(const std::vector<ConsoleCell>& cells, int width, int height, bool anchored) {
+    if (anchored) {
+        buffer += "\033[H\033[2J";
+    }
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const ConsoleCell& cell = cells[y * width + x];
+            appendColors(cell);
+            appendGlyph(cell);
+        }
+        buffer += "\033[0m\n";  // Reset color after each line
+        currentForeground = DEFAULT_COLOR;
+        currentBackground = DEFAULT_COLOR;
+    }
+}
+
+/**
+ * Appends only the cells that differ from the previous frame. The cursor is moved explicitly only when a changed cell
+ * does not directly follow the last cell that was drawn.
+ *
+ * @param cells The cells of the frame in row-major order.
+ * @param width The width of the frame in cells.
+ * @param height The height of the frame in cells.
+ */
+void ConsoleRenderer::appendChangedCells(const std::vector<ConsoleCell>& cells, int width, int height) {
+    int cursorRow = -1;
+    int cursorColumn = -1;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const ConsoleCell& cell = cells[y * width + x];
+            if (cell == previousFrame[y * width + x]) {
+                continue;
+            }
+            if (cursorRow != y || cursorColumn != x) {
+                appendCursorPosition(y, x);
+            }
+            appendColors(cell);
+            appendGlyph(cell);
+            cursorRow = y;
+            cursorColumn = x + 1;
+        }
+    }
+    buffer += "\033[0m";
+    currentForeground = DEFAULT_COLOR;
+    currentBackground = DEFAULT_COLOR;
+    appendCursorPosition(height, 0);
+}
+
+/**
+ * Renders a frame to the given stream with a single write.
+ *
+ * A live frame is anchored to the top left corner of the terminal. If the previous live frame had the same size, only
+ * the cells that changed since then are emitted, so an unchanged network costs a few bytes per frame. Frames that are
+ * not live are printed at the current cursor position and reset the frame history.
+ *
+ * @param cells The cells of the frame in row-major order.
+ * @param width The width of the frame in cells.
+ * @param height The height of the frame in cells.
+ * @param live Whether the frame is part of a live view that is redrawn in place.
+ * @param out The stream to write the frame to.
+ */
+void ConsoleRenderer::render(const std::vector<ConsoleCell>& cells, int width, int height, bool live,
+                             std::ostream& out) {
+    buffer.clear();
+    currentForeground = DEFAULT_COLOR;
+    currentBackground = DEFAULT_COLOR;
+
+    if (!live) {
+        reset();
+        appendFullFrame(cells, width, height, false);
+    } else if (width != previousWidth || height != previousHeight) {
+        appendFullFrame(cells, width, height, true);
+    } else {
+        appendChangedCells(cells, width, height);
+    }
+
+    if (live) {
+        previousFrame = cells;
+        previousWidth = width;
+        previousHeight = height;
+    }
+
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out.flush();
+}
+
+/**
+ * Forgets the previous frame, so the next live frame is drawn in full.
+ */
+void ConsoleRenderer::reset() {
+    previousFrame.clear();
+    previousWidth = 0;
+    previousHeight = 0;
+}
@@ -0,0 +1,53 @@
+#ifndef CONSOLERENDERER_H
+#define CONSOLERENDERER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// A single character cell of a console frame. Colors are packed as 0xRRGGBB, or DEFAULT_COLOR for the terminal's
+// own color. A glyph of 0 is drawn as an upper half block, so the foreground paints the top half of the cell and the
+// background paints the bottom half.
+struct ConsoleCell {
+    char glyph;
+    uint32_t foreground;
+    uint32_t background;
+
+    bool operator==(const ConsoleCell& other) const {
+        return glyph == other.glyph && foreground == other.foreground && background == other.background;
+    }
+
+    bool operator!=(const ConsoleCell& other) const {
+        return !(*this == other);
+    }
+};
+
+class ConsoleRenderer {
+private:
+    std::vector<ConsoleCell> previousFrame;
+    int previousWidth = 0;
+    int previousHeight = 0;
+    std::string buffer;
+    uint32_t currentForeground = DEFAULT_COLOR;
+    uint32_t currentBackground = DEFAULT_COLOR;
+
+    void appendColors(const ConsoleCell& cell);
+
+    void appendGlyph(const ConsoleCell& cell);
+
+    void appendCursorPosition(int row, int column);
+
+    void appendFullFrame(const std::vector<ConsoleCell>& cells, int width, int height, bool anchored);
+
+    void appendChangedCells(const std::vector<ConsoleCell>& cells, int width, int height);
+
+public:
+    static constexpr uint32_t DEFAULT_COLOR = 0xFF000000;
+
+    void render(const std::vector<ConsoleCell>& cells, int width, int height, bool live, std::ostream& out);
+
+    void reset();
+};
+
+#endif // CONSOLERENDERER_H
@@ -0,0 +1,174 @@
+#include "FrameRecorder.h"
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+FrameRecorder::FrameRecorder(Topography* topography) : topography(topography) {}
+
+FrameRecorder::~FrameRecorder() {
+    stop();
+}
+
+/**
+ * Starts a new recording. The terrain of the viewport is rendered here, so changes to the elevation data during the
+ * recording are not shown.
+ *
+ * @param path The directory to write the bitmaps to, or the name of the video file.
+ * @param format The output format of the recording.
+ * @param viewport The part of the map to record, and how far to zoom out.
+ * @param framesPerSecond The frame rate stored in the video header. Bitmap sequences have no frame rate.
+ * @return true if the recording started, false if a recording is already running or the output can't be created.
+ */
+bool FrameRecorder::start(const std::string& path, RecordingFormat format, const Viewport& viewport,
+                          int framesPerSecond) {
+    std::unique_lock<std::mutex> lock(recorderMutex);
+    if (recording) {
+        return false;
+    }
+
+    this->path = path;
+    this->format = format;
+    this->viewport = viewport;
+    terrain = topography->renderTerrain(viewport);
+    coverage.clear();
+    coverageNodes.clear();
+
+    if (format == RecordingFormat::Y4M) {
+        video.open(path, std::ios::binary);
+        if (!video.is_open()) {
+            std::cout << "Unable to open file: " << path << std::endl;
+            return false;
+        }
+        // 4:4:4 chroma keeps the one pixel wide connection lines and drones in full color
+        video << "YUV4MPEG2 W" << terrain.width << " H" << terrain.height << " F" << framesPerSecond
+              << ":1 Ip A1:1 C444\n";
+    } else {
+        std::filesystem::create_directories(path);
+    }
+
+    encoder = std::make_unique<Workers>(1);
+    encoder->start();
+    frameCount = 0;
+    recording = true;
+    return true;
+}
+
+/**
+ * Renders a frame of the network and queues it for encoding. The signal coverage from the previous frame is reused if
+ * no node moved or changed its signal power since then. If the encoder falls MAX_PENDING_FRAMES frames behind, this
+ * waits until it catches up, so a slow disk can't fill up the memory.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param messagePath Pairs of nodes that a message was passed between.
+ */
+void FrameRecorder::recordFrame(const std::vector<Node*>& nodes,
+                                const std::vector<std::pair<Node*, Node*>>& messagePath) {
+    std::unique_lock<std::mutex> lock(recorderMutex);
+    if (!recording) {
+        return;
+    }
+
+    std::vector<std::tuple<int, int, int, double>> nodeStates;
+    nodeStates.reserve(nodes.size());
+    for (const auto& node : nodes) {
+        nodeStates.emplace_back(node->getX(), node->getY(), node->getZ(), node->getSignalPower());
+    }
+    if (coverage.empty() || nodeStates != coverageNodes) {
+        coverage = topography->renderCoverage(nodes, viewport);
+        coverageNodes = std::move(nodeStates);
+    }
+
+    auto frame = std::make_shared<PixelImage>(topography->compositeMap(terrain, coverage, nodes, messagePath,
+                                                                       viewport));
+    {
+        std::unique_lock<std::mutex> queueLock(queueMutex);
+        queueCondition.wait(queueLock, [this] { return pendingFrames < MAX_PENDING_FRAMES; });
+        pendingFrames++;
+    }
+    int frameNumber = frameCount++;
+    encoder->post([this, frame, frameNumber] {
+        encodeFrame(*frame, frameNumber);
+        {
+            std::unique_lock<std::mutex> queueLock(queueMutex);
+            pendingFrames--;
+        }
+        queueCondition.notify_all();
+    });
+}
+
+/**
+ * Writes a frame in the format of the recording. Only called from the encoder thread, so frames are written in the
+ * order they were recorded.
+ *
+ * @param frame The frame to write.
+ * @param frameNumber The number of the frame, starting at 0.
+ */
+void FrameRecorder::encodeFrame(const PixelImage& frame, int frameNumber) {
+    if (format == RecordingFormat::Y4M) {
+        writeY4MFrame(frame);
+        return;
+    }
+
+    std::ostringstream filename;
+    filename << path << "/frame_" << std::setw(5) << std::setfill('0') << frameNumber << ".bmp";
+    std::ofstream file(filename.str(), std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Unable to open file: " << filename.str() << std::endl;
+        return;
+    }
+    Topography::writeImageToBMP(frame, file);
+}
+
+/**
+ * Appends a frame to the Y4M video. The colors are converted to limited range BT.601 YCbCr with integer arithmetic,
+ * and written as three full resolution planes. The first row of the frame is the top of the video.
+ *
+ * @param frame The frame to write.
+ */
+void FrameRecorder::writeY4MFrame(const PixelImage& frame) {
+    size_t size = static_cast<size_t>(frame.width) * frame.height;
+    std::vector<uint8_t> planes(size * 3);
+    uint8_t* luma = planes.data();
+    uint8_t* blueDifference = luma + size;
+    uint8_t* redDifference = blueDifference + size;
+    for (size_t i = 0; i < size; ++i) {
+        int blue = frame.pixels[i * 3];
+        int green = frame.pixels[i * 3 + 1];
+        int red = frame.pixels[i * 3 + 2];
+        luma[i] = static_cast<uint8_t>(((66 * red + 129 * green + 25 * blue + 128) >> 8) + 16);
+        blueDifference[i] = static_cast<uint8_t>(((-38 * red - 74 * green + 112 * blue + 128) >> 8) + 128);
+        redDifference[i] = static_cast<uint8_t>(((112 * red - 94 * green - 18 * blue + 128) >> 8) + 128);
+    }
+    video << "FRAME\n";
+    video.write(reinterpret_cast<const char*>(planes.data()), static_cast<std::streamsize>(planes.size()));
+}
+
+/**
+ * Stops the recording, after every queued frame has been written.
+ *
+ * @return The number of frames in the recording, or 0 if nothing was being recorded.
+ */
+int FrameRecorder::stop() {
+    std::unique_lock<std::mutex> lock(recorderMutex);
+    if (!recording) {
+        return 0;
+    }
+    encoder->stop();
+    encoder.reset();
+    if (video.is_open()) {
+        video.close();
+    }
+    recording = false;
+    return frameCount;
+}
+
+/**
+ * Returns whether a recording is running.
+ *
+ * @return true if frames are being recorded.
+ */
+bool FrameRecorder::isRecording() {
+    std::unique_lock<std::mutex> lock(recorderMutex);
+    return recording;
+}
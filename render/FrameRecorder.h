@@ -0,0 +1,65 @@
+#ifndef FRAMERECORDER_H
+#define FRAMERECORDER_H
+
+#include "../node/Node.h"
+#include "../topography/Topography.h"
+#include "../worker/Workers.h"
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Output formats of a recording. A bitmap sequence writes one numbered BMP file per frame, and Y4M writes every frame
+// into a single uncompressed YUV4MPEG2 video that ffmpeg and most video players can read.
+enum class RecordingFormat {
+    BMP_SEQUENCE,
+    Y4M
+};
+
+// Records the simulation as a sequence of frames, one per broadcast round. The terrain is rendered once when the
+// recording starts, and the signal coverage is only computed again when a node moved, so most frames only cost drawing
+// the nodes and the message path. Frames are encoded and written on a background thread.
+class FrameRecorder {
+private:
+    Topography* topography;
+    Viewport viewport;
+    RecordingFormat format = RecordingFormat::BMP_SEQUENCE;
+    std::string path;
+    PixelImage terrain;
+    std::vector<int> coverage;
+    std::vector<std::tuple<int, int, int, double>> coverageNodes;
+    std::unique_ptr<Workers> encoder;
+    std::ofstream video;
+    std::mutex recorderMutex;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    int pendingFrames = 0;
+    int frameCount = 0;
+    bool recording = false;
+
+    void encodeFrame(const PixelImage& frame, int frameNumber);
+
+    void writeY4MFrame(const PixelImage& frame);
+
+public:
+    // The number of frames that may wait for the encoder before recordFrame() blocks
+    static constexpr int MAX_PENDING_FRAMES = 8;
+
+    explicit FrameRecorder(Topography* topography);
+
+    ~FrameRecorder();
+
+    bool start(const std::string& path, RecordingFormat format, const Viewport& viewport, int framesPerSecond = 10);
+
+    void recordFrame(const std::vector<Node*>& nodes, const std::vector<std::pair<Node*, Node*>>& messagePath);
+
+    int stop();
+
+    bool isRecording();
+};
+
+#endif // FRAMERECORDER_H
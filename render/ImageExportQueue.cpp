@@ -0,0 +1,129 @@
+#include "ImageExportQueue.h"
+#include <map>
+
+ImageExportQueue::ImageExportQueue(Topography* topography, int maxPending)
+        : topography(topography), maxPending(std::max(maxPending, 1)) {}
+
+ImageExportQueue::~ImageExportQueue() {
+    stop();
+}
+
+/**
+ * Sets the function that is called on the export thread after an image has been written.
+ *
+ * @param callback Called with the name of the file that was written.
+ */
+void ImageExportQueue::setOnExported(std::function<void(const std::string&)> callback) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    onExported = std::move(callback);
+}
+
+/**
+ * Queues an image for export. Only the id, position and signal power of the nodes are copied, and the message path is
+ * stored as indices into the copied nodes, so taking the snapshot is cheap even for large networks. This never waits:
+ * if maxPending images are already queued or being written, the export is rejected.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param connectedDrones Vector of pairs of connected drones.
+ * @param filename The name of the file to write to.
+ * @param viewport The part of the map to write, and how far to zoom out.
+ * @param format The pixel format of the file.
+ * @param progressive Whether to write a coarse preview first, like writeMapToBMPProgressive().
+ * @return true if the image was queued, false if the queue is full.
+ */
+bool ImageExportQueue::submit(const std::vector<Node*>& nodes,
+                              const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                              const std::string& filename, const Viewport& viewport, BitmapFormat format,
+                              bool progressive) {
+    auto job = std::make_shared<ExportJob>();
+    job->filename = filename;
+    job->viewport = viewport;
+    job->format = format;
+    job->progressive = progressive;
+    job->nodes.reserve(nodes.size());
+    std::map<const Node*, int> indices;
+    for (const auto& node : nodes) {
+        indices[node] = static_cast<int>(job->nodes.size());
+        job->nodes.emplace_back(node->getId(), node->getX(), node->getY(), node->getZ(), node->getSignalPower(),
+                                topography);
+    }
+    for (const auto& connectedDrone : connectedDrones) {
+        auto first = indices.find(connectedDrone.first);
+        auto second = indices.find(connectedDrone.second);
+        if (first != indices.end() && second != indices.end()) {
+            job->path.emplace_back(first->second, second->second);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+    if (pendingExports >= maxPending) {
+        return false;
+    }
+    pendingExports++;
+    if (!exporter) {
+        exporter = std::make_unique<Workers>(1);
+        exporter->start();
+    }
+    exporter->post([this, job] {
+        exportImage(*job);
+        std::function<void(const std::string&)> callback;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            pendingExports--;
+            callback = onExported;
+        }
+        if (callback) {
+            callback(job->filename);
+        }
+    });
+    return true;
+}
+
+/**
+ * Renders and writes a queued image. Runs on the export thread.
+ *
+ * @param job The snapshot to render.
+ */
+void ImageExportQueue::exportImage(ExportJob& job) {
+    std::vector<Node*> nodes;
+    nodes.reserve(job.nodes.size());
+    for (auto& node : job.nodes) {
+        nodes.push_back(&node);
+    }
+    std::vector<std::pair<Node*, Node*>> connectedDrones;
+    connectedDrones.reserve(job.path.size());
+    for (const auto& step : job.path) {
+        connectedDrones.emplace_back(nodes[step.first], nodes[step.second]);
+    }
+
+    if (job.progressive) {
+        topography->writeMapToBMPProgressive(nodes, connectedDrones, job.filename, job.viewport, job.format);
+    } else {
+        topography->writeMapToBMP(nodes, connectedDrones, job.filename, job.viewport, job.format);
+    }
+}
+
+/**
+ * Returns the number of images that are queued or being written.
+ *
+ * @return The number of unfinished exports.
+ */
+int ImageExportQueue::getPendingCount() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    return pendingExports;
+}
+
+/**
+ * Waits until every queued image has been written, and stops the export thread. Exports submitted afterwards start a
+ * new export thread.
+ */
+void ImageExportQueue::stop() {
+    std::unique_ptr<Workers> finished;
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        finished = std::move(exporter);
+    }
+    if (finished) {
+        finished->stop();
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef IMAGEEXPORTQUEUE_H
+#define IMAGEEXPORTQUEUE_H
+
+#include "../node/Node.h"
+#include "../topography/Topography.h"
+#include "../worker/Workers.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Writes map images on a background thread, so the CLI can keep taking commands while large images are rendered. Every
+// export works on a snapshot of the node positions and the message path taken when it was submitted, so the nodes can
+// move and broadcast while it waits in the queue.
+class ImageExportQueue {
+private:
+    // Everything needed to render an image, copied from the simulation
+    struct ExportJob {
+        std::vector<Node> nodes;
+        std::vector<std::pair<int, int>> path;
+        std::string filename;
+        Viewport viewport;
+        BitmapFormat format;
+        bool progressive;
+    };
+
+    Topography* topography;
+    int maxPending;
+    std::unique_ptr<Workers> exporter;
+    std::function<void(const std::string&)> onExported;
+    std::mutex queueMutex;
+    int pendingExports = 0;
+
+    void exportImage(ExportJob& job);
+
+public:
+    ImageExportQueue(Topography* topography, int maxPending = 4);
+
+    ~ImageExportQueue();
+
+    void setOnExported(std::function<void(const std::string&)> callback);
+
+    bool submit(const std::vector<Node*>& nodes, const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                const std::string& filename, const Viewport& viewport, BitmapFormat format, bool progressive);
+
+    int getPendingCount();
+
+    void stop();
+};
+
+#endif // IMAGEEXPORTQUEUE_H
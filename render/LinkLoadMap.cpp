@@ -0,0 +1,214 @@
+#include "LinkLoadMap.h"
+#include "../worker/Workers.h"
+#include <algorithm>
+#include <cmath>
+
+// Depths of nodes whose route to the destination is not known yet, is being followed, or never reaches it
+const int DEPTH_UNKNOWN = -1;
+const int DEPTH_VISITING = -2;
+const int DEPTH_UNREACHABLE = -3;
+
+LinkLoadMap::LinkLoadMap(Topography* topography, int numberOfThreads)
+        : topography(topography), numberOfThreads(std::max(numberOfThreads, 1)) {}
+
+/**
+ * Counts the routes from every node to one destination over each link.
+ *
+ * The next hops towards a destination form a tree rooted at the destination, so the number of routes over the link from
+ * a node to its next hop is the number of nodes in the subtree of the node. The depth of every node in the tree is
+ * found by following its next hops until a node with a known depth, so every node is only visited once. Nodes are then
+ * processed from the deepest up, adding the size of their subtree to their next hop. Routes that end at a node without
+ * a route, or that run in a loop because of outdated tables, never reach the destination and are not counted.
+ *
+ * @param nodes Vector of pointers to the nodes.
+ * @param indices The index in nodes of every node id.
+ * @param destination The index of the destination node.
+ * @param nextHops Buffer for the next hop of every node.
+ * @param depths Buffer for the number of hops from every node to the destination.
+ * @param routes Buffer for the size of the subtree of every node.
+ * @param loads The link loads to add the routes to.
+ */
+void LinkLoadMap::countRoutesTo(const std::vector<Node*>& nodes, const std::map<int, int>& indices, int destination,
+                                std::vector<int>& nextHops, std::vector<int>& depths, std::vector<long long>& routes,
+                                LinkLoads& loads) {
+    int count = static_cast<int>(nodes.size());
+    int destinationId = nodes[destination]->getId();
+    for (int node = 0; node < count; ++node) {
+        RouteEntry route = nodes[node]->getRoutingTable().get(destinationId);
+        nextHops[node] = -1;
+        if (route.nextHop != RouteEntry::NO_NEXT_HOP && route.hops != RouteEntry::INFINITE_HOPS) {
+            auto nextHop = indices.find(route.nextHop);
+            if (nextHop != indices.end()) {
+                nextHops[node] = nextHop->second;
+            }
+        }
+    }
+
+    depths.assign(count, DEPTH_UNKNOWN);
+    depths[destination] = 0;
+    std::vector<int> chain;
+    int maxDepth = 0;
+    for (int start = 0; start < count; ++start) {
+        int node = start;
+        while (node != -1 && depths[node] == DEPTH_UNKNOWN) {
+            depths[node] = DEPTH_VISITING;
+            chain.push_back(node);
+            node = nextHops[node];
+        }
+        // Reaching a node that is still being visited means the route runs in a loop
+        int depth = node == -1 || depths[node] < 0 ? DEPTH_UNREACHABLE : depths[node];
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            if (depth != DEPTH_UNREACHABLE) {
+                depth++;
+                maxDepth = std::max(maxDepth, depth);
+            }
+            depths[*it] = depth;
+        }
+        chain.clear();
+    }
+
+    // Sort the nodes by depth, so every subtree is complete before it is added to its next hop
+    std::vector<int> firstOfDepth(maxDepth + 2, 0);
+    for (int node = 0; node < count; ++node) {
+        if (depths[node] > 0) {
+            firstOfDepth[depths[node] + 1]++;
+        }
+    }
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        firstOfDepth[depth + 1] += firstOfDepth[depth];
+    }
+    std::vector<int> byDepth(firstOfDepth[maxDepth + 1]);
+    for (int node = 0; node < count; ++node) {
+        if (depths[node] > 0) {
+            byDepth[firstOfDepth[depths[node]]++] = node;
+        }
+    }
+
+    routes.assign(count, 1);
+    for (auto it = byDepth.rbegin(); it != byDepth.rend(); ++it) {
+        int node = *it;
+        int nextHop = nextHops[node];
+        routes[nextHop] += routes[node];
+        loads[{std::min(node, nextHop), std::max(node, nextHop)}] += routes[node];
+    }
+}
+
+/**
+ * Counts how many routes between two nodes use each link, by following the next hops in the routing tables. The
+ * destinations are divided between the threads, which each count into their own map, and the maps are added up at the
+ * end.
+ *
+ * @param nodes Vector of pointers to the nodes.
+ * @return The number of routes over each link that is used by at least one route.
+ */
+LinkLoadMap::LinkLoads LinkLoadMap::computeLinkLoads(const std::vector<Node*>& nodes) {
+    std::map<int, int> indices;
+    for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
+        indices[nodes[i]->getId()] = i;
+    }
+
+    int threads = std::min(numberOfThreads, std::max(static_cast<int>(nodes.size()), 1));
+    std::vector<LinkLoads> partialLoads(threads);
+    Workers workers(threads);
+    workers.start();
+    for (int thread = 0; thread < threads; ++thread) {
+        workers.post([this, &nodes, &indices, &partialLoads, threads, thread] {
+            std::vector<int> nextHops(nodes.size());
+            std::vector<int> depths;
+            std::vector<long long> routes;
+            for (int destination = thread; destination < static_cast<int>(nodes.size()); destination += threads) {
+                countRoutesTo(nodes, indices, destination, nextHops, depths, routes, partialLoads[thread]);
+            }
+        });
+    }
+    workers.stop();
+
+    LinkLoads loads = std::move(partialLoads[0]);
+    for (int thread = 1; thread < threads; ++thread) {
+        for (const auto& [link, load] : partialLoads[thread]) {
+            loads[link] += load;
+        }
+    }
+    return loads;
+}
+
+/**
+ * Renders the link loads as a heat map on top of the terrain. Every used link is drawn as a line from yellow for the
+ * least used links to red for the most used, on a logarithmic scale, and busier links are drawn on top. Nodes are
+ * drawn in blue.
+ *
+ * @param nodes Vector of pointers to the nodes.
+ * @param loads The link loads from computeLinkLoads().
+ * @param viewport The part of the map to render, and how far to zoom out.
+ * @return The rendered image.
+ */
+PixelImage LinkLoadMap::render(const std::vector<Node*>& nodes, const LinkLoads& loads, const Viewport& viewport) {
+    Viewport view = topography->clampViewport(viewport);
+    PixelImage image = topography->renderTerrain(view);
+
+    auto setPixel = [&](int x, int y, uint8_t blue, uint8_t green, uint8_t red) {
+        if (x >= view.x && x < view.x + view.width && y >= view.y && y < view.y + view.height) {
+            size_t index = static_cast<size_t>((y - view.y) / view.zoom) * image.width + (x - view.x) / view.zoom;
+            image.pixels[index * 3] = blue;
+            image.pixels[index * 3 + 1] = green;
+            image.pixels[index * 3 + 2] = red;
+        }
+    };
+
+    std::vector<std::pair<long long, std::pair<int, int>>> links;
+    long long maxLoad = 1;
+    for (const auto& [link, load] : loads) {
+        links.emplace_back(load, link);
+        maxLoad = std::max(maxLoad, load);
+    }
+    std::sort(links.begin(), links.end());
+
+    for (const auto& [load, link] : links) {
+        double heat = std::log1p(static_cast<double>(load)) / std::log1p(static_cast<double>(maxLoad));
+        auto green = static_cast<uint8_t>(255 * (1.0 - heat));
+        int x0 = nodes[link.first]->getX(), y0 = nodes[link.first]->getY();
+        int x1 = nodes[link.second]->getX(), y1 = nodes[link.second]->getY();
+        int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+        int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+        int err = dx + dy;
+        while (true) {
+            setPixel(x0, y0, 0, green, 255);
+            if (x0 == x1 && y0 == y1) {
+                break;
+            }
+            int e2 = 2 * err;
+            if (e2 >= dy) {
+                err += dy;
+                x0 += sx;
+            }
+            if (e2 <= dx) {
+                err += dx;
+                y0 += sy;
+            }
+        }
+    }
+
+    for (const auto& node : nodes) {
+        setPixel(node->getX(), node->getY(), 255, 0, 0);
+    }
+    return image;
+}
+
+/**
+ * Writes the link loads as a heat map to a 24-bit BMP image file.
+ *
+ * @param nodes Vector of pointers to the nodes.
+ * @param loads The link loads from computeLinkLoads().
+ * @param filename The name of the file to write to.
+ * @param viewport The part of the map to write, and how far to zoom out.
+ */
+void LinkLoadMap::write(const std::vector<Node*>& nodes, const LinkLoads& loads, const std::string& filename,
+                        const Viewport& viewport) {
+    PixelImage image = render(nodes, loads, viewport);
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Unable to open file: " << filename << std::endl;
+        return;
+    }
+    Topography::writeImageToBMP(image, file);
+}
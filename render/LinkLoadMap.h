@@ -0,0 +1,36 @@
+#ifndef LINKLOADMAP_H
+#define LINKLOADMAP_H
+
+#include "../node/Node.h"
+#include "../topography/Topography.h"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Counts how many routes use each radio link, following the next hops in the routing tables of the nodes, and draws the
+// counts as a heat map. Links that carry many routes are the bottlenecks of the network.
+class LinkLoadMap {
+private:
+    Topography* topography;
+    int numberOfThreads;
+
+    void countRoutesTo(const std::vector<Node*>& nodes, const std::map<int, int>& indices, int destination,
+                       std::vector<int>& nextHops, std::vector<int>& depths, std::vector<long long>& routes,
+                       std::map<std::pair<int, int>, long long>& loads);
+
+public:
+    // The number of routes over each link, keyed by the indices of the two nodes with the lower index first
+    using LinkLoads = std::map<std::pair<int, int>, long long>;
+
+    LinkLoadMap(Topography* topography, int numberOfThreads);
+
+    LinkLoads computeLinkLoads(const std::vector<Node*>& nodes);
+
+    PixelImage render(const std::vector<Node*>& nodes, const LinkLoads& loads, const Viewport& viewport);
+
+    void write(const std::vector<Node*>& nodes, const LinkLoads& loads, const std::string& filename,
+               const Viewport& viewport);
+};
+
+#endif // LINKLOADMAP_H
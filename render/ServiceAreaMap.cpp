@@ -0,0 +1,260 @@
+#include "ServiceAreaMap.h"
+#include <cstdint>
+#include <limits>
+
+/**
+ * Converts a hue to a saturated color.
+ *
+ * @param hue The hue, between 0 and 1.
+ * @param pixel Receives the color in blue, green, red order.
+ */
+static void hueToColor(double hue, uint8_t* pixel) {
+    double h = (hue - std::floor(hue)) * 6.0;
+    double fraction = h - std::floor(h);
+    double value = 255.0;
+    double low = value * 0.25;
+    double falling = value * (1.0 - 0.75 * fraction);
+    double rising = value * (0.25 + 0.75 * fraction);
+    double red, green, blue;
+    switch (static_cast<int>(h)) {
+        case 0: red = value; green = rising; blue = low; break;
+        case 1: red = falling; green = value; blue = low; break;
+        case 2: red = low; green = value; blue = rising; break;
+        case 3: red = low; green = falling; blue = value; break;
+        case 4: red = rising; green = low; blue = value; break;
+        default: red = value; green = low; blue = falling; break;
+    }
+    pixel[0] = static_cast<uint8_t>(blue);
+    pixel[1] = static_cast<uint8_t>(green);
+    pixel[2] = static_cast<uint8_t>(red);
+}
+
+ServiceAreaMap::ServiceAreaMap(Topography* topography) : topography(topography) {}
+
+/**
+ * Finds the nearest node of every output pixel of a viewport.
+ *
+ * The map is divided into blocks of zoom x zoom cells lined up with the viewport, and every node is placed in the
+ * block that contains it. The exact squared Euclidean distance transform of Felzenszwalb and Huttenlocher is then
+ * computed in two passes: the first finds the nearest node in the same column of blocks, and the second takes the
+ * lower envelope of the parabolas (x - q)^2 + columnDistance(q)^2 along every row, keeping track of which node each
+ * parabola belongs to. Both passes are linear in the number of blocks. Nodes outside the viewport are included, so
+ * their service areas reach into it correctly.
+ *
+ * A pixel whose nearest node is too far away for a link to it is not covered. With equal signal power, this makes every
+ * pixel belong to the nearest node that is in range of it. Obstructions are not taken into account.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param viewport The part of the map to compute, and how far to zoom out.
+ * @return The index in nodes of the nearest node of every output pixel in row-major order, or NO_NODE.
+ */
+std::vector<int> ServiceAreaMap::computeNearestNodes(const std::vector<Node*>& nodes, const Viewport& viewport) {
+    Viewport view = topography->clampViewport(viewport);
+    Viewport map = topography->clampViewport(Viewport());
+    int zoom = view.zoom;
+    int width = (view.width + zoom - 1) / zoom;
+    int height = (view.height + zoom - 1) / zoom;
+
+    // The grid of blocks covers the whole map, with the blocks of the viewport starting at (offsetX, offsetY)
+    int offsetX = (view.x + zoom - 1) / zoom;
+    int offsetY = (view.y + zoom - 1) / zoom;
+    int originX = view.x - offsetX * zoom;
+    int originY = view.y - offsetY * zoom;
+    int gridWidth = (map.width - originX + zoom - 1) / zoom;
+    int gridHeight = (map.height - originY + zoom - 1) / zoom;
+
+    std::vector<int> sites(static_cast<size_t>(gridWidth) * gridHeight, NO_NODE);
+    for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
+        int column = (nodes[i]->getX() - originX) / zoom;
+        int row = (nodes[i]->getY() - originY) / zoom;
+        if (column >= 0 && column < gridWidth && row >= 0 && row < gridHeight) {
+            int& site = sites[static_cast<size_t>(row) * gridWidth + column];
+            if (site == NO_NODE) {
+                site = i;
+            }
+        }
+    }
+
+    // First pass: the nearest node in the same column, from above and from below
+    const int64_t infinity = std::numeric_limits<int64_t>::max() / 4;
+    std::vector<int64_t> columnDistance(sites.size(), infinity);
+    std::vector<int> columnNode(sites.size(), NO_NODE);
+    for (int x = 0; x < gridWidth; ++x) {
+        int last = -1;
+        for (int y = 0; y < gridHeight; ++y) {
+            size_t index = static_cast<size_t>(y) * gridWidth + x;
+            if (sites[index] != NO_NODE) {
+                last = y;
+            }
+            if (last >= 0) {
+                columnDistance[index] = y - last;
+                columnNode[index] = sites[static_cast<size_t>(last) * gridWidth + x];
+            }
+        }
+        last = -1;
+        for (int y = gridHeight - 1; y >= 0; --y) {
+            size_t index = static_cast<size_t>(y) * gridWidth + x;
+            if (sites[index] != NO_NODE) {
+                last = y;
+            }
+            if (last >= 0 && last - y < columnDistance[index]) {
+                columnDistance[index] = last - y;
+                columnNode[index] = sites[static_cast<size_t>(last) * gridWidth + x];
+            }
+        }
+    }
+
+    // Second pass: the lower envelope of the column distances along every row of the viewport
+    std::vector<int> nearest(static_cast<size_t>(width) * height, NO_NODE);
+    std::vector<int> parabolas(gridWidth);
+    std::vector<double> boundaries(gridWidth + 1);
+    std::vector<int64_t> rowDistance(gridWidth);
+    for (int y = 0; y < height; ++y) {
+        size_t rowStart = static_cast<size_t>(y + offsetY) * gridWidth;
+        for (int q = 0; q < gridWidth; ++q) {
+            int64_t distance = columnDistance[rowStart + q];
+            rowDistance[q] = distance == infinity ? infinity : distance * distance;
+        }
+
+        int count = 0;
+        for (int q = 0; q < gridWidth; ++q) {
+            if (rowDistance[q] == infinity) {
+                continue;
+            }
+            if (count == 0) {
+                parabolas[0] = q;
+                boundaries[0] = -std::numeric_limits<double>::infinity();
+                boundaries[1] = std::numeric_limits<double>::infinity();
+                count = 1;
+                continue;
+            }
+            double intersection;
+            while (true) {
+                int p = parabolas[count - 1];
+                intersection = static_cast<double>((rowDistance[q] + static_cast<int64_t>(q) * q) -
+                                                   (rowDistance[p] + static_cast<int64_t>(p) * p)) / (2.0 * (q - p));
+                if (intersection > boundaries[count - 1]) {
+                    break;
+                }
+                count--;
+            }
+            parabolas[count] = q;
+            boundaries[count] = intersection;
+            boundaries[count + 1] = std::numeric_limits<double>::infinity();
+            count++;
+        }
+        if (count == 0) {
+            continue;
+        }
+
+        int k = 0;
+        for (int x = 0; x < width; ++x) {
+            int column = x + offsetX;
+            while (boundaries[k + 1] < column) {
+                k++;
+            }
+            int node = columnNode[rowStart + parabolas[k]];
+
+            // Only pixels that are in range of their nearest node are covered, measured at the center of the block
+            int blockX = originX + column * zoom;
+            int blockY = originY + (y + offsetY) * zoom;
+            double dx = blockX + std::min(zoom, map.width - blockX) / 2 - nodes[node]->getX();
+            double dy = blockY + std::min(zoom, map.height - blockY) / 2 - nodes[node]->getY();
+            double rangeSquared = nodes[node]->getSignalPower() / (2.0 * M_PI * Node::MIN_SIGNAL_STRENGTH);
+            if (dx * dx + dy * dy <= rangeSquared) {
+                nearest[static_cast<size_t>(y) * width + x] = node;
+            }
+        }
+    }
+    return nearest;
+}
+
+/**
+ * Renders a service area map. Every covered pixel is tinted by the color of its nearest node, either a color unique to
+ * the node or a color from green to red for the number of hops from the node to the destination. Nodes without a route
+ * to the destination are purple. The borders between service areas are darkened, and the nodes are drawn in red.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param viewport The part of the map to render, and how far to zoom out.
+ * @param mode What the service areas are colored by.
+ * @param destination The id of the destination node when coloring by hop count.
+ * @return The rendered image.
+ */
+PixelImage ServiceAreaMap::render(const std::vector<Node*>& nodes, const Viewport& viewport, ServiceAreaMode mode,
+                                  int destination) {
+    Viewport view = topography->clampViewport(viewport);
+    PixelImage image = topography->renderTerrain(view);
+    std::vector<int> nearest = computeNearestNodes(nodes, view);
+
+    std::vector<uint8_t> colors(nodes.size() * 3);
+    double maxHops = 0;
+    std::vector<double> hops(nodes.size(), -1);
+    if (mode == ServiceAreaMode::HOP_COUNT) {
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            RouteEntry route = nodes[i]->getRoutingTable().get(destination);
+            if (route.nextHop != RouteEntry::NO_NEXT_HOP && route.hops != RouteEntry::INFINITE_HOPS) {
+                hops[i] = route.hops;
+                maxHops = std::max(maxHops, hops[i]);
+            }
+        }
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        uint8_t* color = &colors[i * 3];
+        if (mode == ServiceAreaMode::NEAREST_NODE) {
+            // Consecutive ids get hues far apart
+            hueToColor(nodes[i]->getId() * 0.618033988749895, color);
+        } else if (hops[i] < 0) {
+            color[0] = 160; color[1] = 0; color[2] = 160;
+        } else {
+            hueToColor((maxHops > 0 ? 1.0 - hops[i] / maxHops : 1.0) / 3.0, color);
+        }
+    }
+
+    int width = image.width;
+    int height = image.height;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int node = nearest[static_cast<size_t>(y) * width + x];
+            if (node == NO_NODE) {
+                continue;
+            }
+            bool border = (x + 1 < width && nearest[static_cast<size_t>(y) * width + x + 1] != node) ||
+                          (y + 1 < height && nearest[static_cast<size_t>(y + 1) * width + x] != node);
+            uint8_t* pixel = &image.pixels[(static_cast<size_t>(y) * width + x) * 3];
+            for (int channel = 0; channel < 3; ++channel) {
+                int blended = (pixel[channel] * 45 + colors[node * 3 + channel] * 55) / 100;
+                pixel[channel] = static_cast<uint8_t>(border ? blended / 2 : blended);
+            }
+        }
+    }
+
+    for (const auto& node : nodes) {
+        int x = node->getX() - view.x;
+        int y = node->getY() - view.y;
+        if (x >= 0 && x < view.width && y >= 0 && y < view.height) {
+            uint8_t* pixel = &image.pixels[(static_cast<size_t>(y / view.zoom) * width + x / view.zoom) * 3];
+            pixel[0] = 0; pixel[1] = 0; pixel[2] = 255;
+        }
+    }
+    return image;
+}
+
+/**
+ * Writes a service area map to a 24-bit BMP image file.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param filename The name of the file to write to.
+ * @param viewport The part of the map to write, and how far to zoom out.
+ * @param mode What the service areas are colored by.
+ * @param destination The id of the destination node when coloring by hop count.
+ */
+void ServiceAreaMap::write(const std::vector<Node*>& nodes, const std::string& filename, const Viewport& viewport,
+                           ServiceAreaMode mode, int destination) {
+    PixelImage image = render(nodes, viewport, mode, destination);
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Unable to open file: " << filename << std::endl;
+        return;
+    }
+    Topography::writeImageToBMP(image, file);
+}
@@ -0,0 +1,36 @@
+#ifndef SERVICEAREAMAP_H
+#define SERVICEAREAMAP_H
+
+#include "../node/Node.h"
+#include "../topography/Topography.h"
+#include <string>
+#include <vector>
+
+// What the service areas are colored by
+enum class ServiceAreaMode {
+    NEAREST_NODE,
+    HOP_COUNT
+};
+
+// Renders Voronoi-style service area maps, where every pixel is colored by the nearest node that is in radio range of
+// it. The nearest node of every pixel is found with an exact Euclidean distance transform, which visits every pixel a
+// constant number of times no matter how many nodes there are.
+class ServiceAreaMap {
+private:
+    Topography* topography;
+
+public:
+    static constexpr int NO_NODE = -1;
+
+    explicit ServiceAreaMap(Topography* topography);
+
+    std::vector<int> computeNearestNodes(const std::vector<Node*>& nodes, const Viewport& viewport);
+
+    PixelImage render(const std::vector<Node*>& nodes, const Viewport& viewport, ServiceAreaMode mode,
+                      int destination = 0);
+
+    void write(const std::vector<Node*>& nodes, const std::string& filename, const Viewport& viewport,
+               ServiceAreaMode mode, int destination = 0);
+};
+
+#endif // SERVICEAREAMAP_H
@@ -0,0 +1,119 @@
+#include "SvgExporter.h"
+#include <fstream>
+#include <iostream>
+
+/**
+ * Encodes binary data as base64, for embedding it in a data URI.
+ *
+ * @param data The data to encode.
+ * @return The base64 encoded data.
+ */
+static std::string encodeBase64(const std::string& data) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string encoded;
+    encoded.reserve((data.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 2 < data.size(); i += 3) {
+        uint32_t group = (static_cast<uint8_t>(data[i]) << 16) | (static_cast<uint8_t>(data[i + 1]) << 8) |
+                         static_cast<uint8_t>(data[i + 2]);
+        encoded += alphabet[(group >> 18) & 0x3F];
+        encoded += alphabet[(group >> 12) & 0x3F];
+        encoded += alphabet[(group >> 6) & 0x3F];
+        encoded += alphabet[group & 0x3F];
+    }
+    if (i < data.size()) {
+        uint32_t group = static_cast<uint8_t>(data[i]) << 16;
+        if (i + 1 < data.size()) {
+            group |= static_cast<uint8_t>(data[i + 1]) << 8;
+        }
+        encoded += alphabet[(group >> 18) & 0x3F];
+        encoded += alphabet[(group >> 12) & 0x3F];
+        encoded += i + 1 < data.size() ? alphabet[(group >> 6) & 0x3F] : '=';
+        encoded += '=';
+    }
+    return encoded;
+}
+
+SvgExporter::SvgExporter(Topography* topography, int maxTerrainSize)
+        : topography(topography), maxTerrainSize(maxTerrainSize) {}
+
+/**
+ * Encodes the terrain as an RLE compressed bitmap, zoomed out so it is at most maxTerrainSize pixels wide and high.
+ */
+void SvgExporter::encodeTerrain() {
+    Viewport map = topography->clampViewport(Viewport());
+    mapWidth = map.width;
+    mapHeight = map.height;
+    Viewport viewport = topography->fitViewport(maxTerrainSize, maxTerrainSize);
+    // Every bitmap pixel covers zoom x zoom cells, so the last column and row may reach past the edge of the map
+    terrainWidth = (mapWidth + viewport.zoom - 1) / viewport.zoom * viewport.zoom;
+    terrainHeight = (mapHeight + viewport.zoom - 1) / viewport.zoom * viewport.zoom;
+    terrainImage = "data:image/bmp;base64," + encodeBase64(topography->encodeTerrainBMP(viewport, BitmapFormat::RLE8));
+}
+
+/**
+ * Forgets the cached terrain, so it is encoded again on the next export. Call this after the elevation data changes.
+ */
+void SvgExporter::invalidateTerrain() {
+    terrainImage.clear();
+}
+
+/**
+ * Writes the network to an SVG file. Radio links are drawn as thin green lines, the message path as thick blue lines
+ * and the nodes as red circles with their id and position as a tooltip. Coordinates are map cells, so the image can be
+ * scaled freely without losing detail in the network.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param radioLinks Pairs of nodes that are in radio range of each other.
+ * @param messagePath Pairs of nodes that a message was passed between.
+ * @param filename The name of the file to write to.
+ */
+void SvgExporter::write(const std::vector<Node*>& nodes, const std::vector<std::pair<Node*, Node*>>& radioLinks,
+                        const std::vector<std::pair<Node*, Node*>>& messagePath, const std::string& filename) {
+    if (terrainImage.empty()) {
+        encodeTerrain();
+    }
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cout << "Unable to open file: " << filename << std::endl;
+        return;
+    }
+
+    file << "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" width=\""
+         << mapWidth << "\" height=\"" << mapHeight << "\" viewBox=\"0 0 " << mapWidth << " " << mapHeight << "\">\n";
+
+    // Bitmap rows are stored bottom up, so the terrain is flipped to line up with the map coordinates
+    file << "<image width=\"" << terrainWidth << "\" height=\"" << terrainHeight << "\" preserveAspectRatio=\"none\""
+         << " style=\"image-rendering:pixelated\" transform=\"translate(0 " << terrainHeight << ") scale(1 -1)\""
+         << " xlink:href=\"" << terrainImage << "\"/>\n";
+
+    auto writeLines = [&](const std::vector<std::pair<Node*, Node*>>& lines) {
+        for (const auto& line : lines) {
+            if (line.first == line.second) {
+                continue;
+            }
+            file << "<line x1=\"" << line.first->getX() + 0.5 << "\" y1=\"" << line.first->getY() + 0.5
+                 << "\" x2=\"" << line.second->getX() + 0.5 << "\" y2=\"" << line.second->getY() + 0.5 << "\"/>\n";
+        }
+    };
+
+    file << "<g stroke=\"#00c000\" stroke-opacity=\"0.6\" stroke-width=\"1\">\n";
+    writeLines(radioLinks);
+    file << "</g>\n";
+
+    file << "<g stroke=\"#0000ff\" stroke-width=\"3\" stroke-linecap=\"round\">\n";
+    writeLines(messagePath);
+    file << "</g>\n";
+
+    file << "<g fill=\"#ff0000\" stroke=\"#000000\" stroke-width=\"0.5\">\n";
+    for (const auto& node : nodes) {
+        file << "<circle cx=\"" << node->getX() + 0.5 << "\" cy=\"" << node->getY() + 0.5 << "\" r=\"3\"><title>Node "
+             << node->getId() << " (" << node->getX() << ", " << node->getY() << ", " << node->getZ()
+             << ")</title></circle>\n";
+    }
+    file << "</g>\n";
+
+    file << "</svg>\n";
+    file.close();
+}
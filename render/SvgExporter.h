@@ -0,0 +1,34 @@
+#ifndef SVGEXPORTER_H
+#define SVGEXPORTER_H
+
+#include "../node/Node.h"
+#include "../topography/Topography.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+// Exports the mesh network as an SVG image. The terrain is embedded once as a downscaled bitmap, and nodes, radio links
+// and message paths are drawn as vector shapes on top of it. The encoded terrain is cached, so exporting the network
+// again after the routes change only costs as much as the number of nodes and links.
+class SvgExporter {
+private:
+    Topography* topography;
+    int maxTerrainSize;
+    std::string terrainImage;
+    int mapWidth = 0;
+    int mapHeight = 0;
+    int terrainWidth = 0;
+    int terrainHeight = 0;
+
+    void encodeTerrain();
+
+public:
+    SvgExporter(Topography* topography, int maxTerrainSize = 1024);
+
+    void invalidateTerrain();
+
+    void write(const std::vector<Node*>& nodes, const std::vector<std::pair<Node*, Node*>>& radioLinks,
+               const std::vector<std::pair<Node*, Node*>>& messagePath, const std::string& filename);
+};
+
+#endif // SVGEXPORTER_H
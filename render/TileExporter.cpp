@@ -0,0 +1,252 @@
+#include "TileExporter.h"
+#include "../worker/Workers.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+TileExporter::TileExporter(Topography* topography, std::string directory, int numberOfThreads)
+        : topography(topography), directory(std::move(directory)), numberOfThreads(std::max(numberOfThreads, 1)) {}
+
+/**
+ * Returns the number of tiles needed to cover the map at a zoom level.
+ *
+ * @param zoom The zoom level, where 0 is a single tile for the whole map.
+ * @param horizontal Whether to count the tiles horizontally or vertically.
+ * @return The number of tiles.
+ */
+int TileExporter::getTileCount(int zoom, bool horizontal) const {
+    long long cellsPerTile = static_cast<long long>(TILE_SIZE) << (maxZoom - zoom);
+    long long size = horizontal ? mapWidth : mapHeight;
+    return static_cast<int>((size + cellsPerTile - 1) / cellsPerTile);
+}
+
+/**
+ * Returns the highest zoom level of the last export, where the map is shown at full size.
+ *
+ * @return The highest zoom level.
+ */
+int TileExporter::getMaxZoom() const {
+    return maxZoom;
+}
+
+/**
+ * Renders a tile at the highest zoom level. Parts of the tile outside the map are black.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param connectedDrones Vector of pairs of connected drones.
+ * @param x The column of the tile.
+ * @param y The row of the tile.
+ * @return The rendered tile.
+ */
+PixelImage TileExporter::renderTile(const std::vector<Node*>& nodes,
+                                    const std::vector<std::pair<Node*, Node*>>& connectedDrones, int x, int y) {
+    Viewport viewport;
+    viewport.x = x * TILE_SIZE;
+    viewport.y = y * TILE_SIZE;
+    viewport.width = TILE_SIZE;
+    viewport.height = TILE_SIZE;
+    PixelImage rendered = topography->renderMap(nodes, connectedDrones, viewport);
+
+    PixelImage tile;
+    tile.width = TILE_SIZE;
+    tile.height = TILE_SIZE;
+    tile.pixels.assign(TILE_SIZE * TILE_SIZE * 3, 0);
+    for (int row = 0; row < rendered.height; ++row) {
+        std::copy_n(&rendered.pixels[static_cast<size_t>(row) * rendered.width * 3], rendered.width * 3,
+                    &tile.pixels[static_cast<size_t>(row) * TILE_SIZE * 3]);
+    }
+    return tile;
+}
+
+/**
+ * Combines four tiles into one tile of the zoom level above them, by downsampling each of them to a quarter of the
+ * tile. Every pixel of the result covers 2x2 pixels of a child tile. If any of them is a drone or a line, that color is
+ * kept, so drones and message paths stay visible on every level. Otherwise the colors are averaged.
+ *
+ * @param children The top left, top right, bottom left and bottom right tiles, or nullptr for tiles outside the map.
+ * @return The combined tile.
+ */
+PixelImage TileExporter::combineTiles(const PixelImage* children[4]) {
+    PixelImage tile;
+    tile.width = TILE_SIZE;
+    tile.height = TILE_SIZE;
+    tile.pixels.assign(TILE_SIZE * TILE_SIZE * 3, 0);
+
+    const int half = TILE_SIZE / 2;
+    for (int child = 0; child < 4; ++child) {
+        if (children[child] == nullptr) {
+            continue;
+        }
+        const std::vector<uint8_t>& source = children[child]->pixels;
+        int offsetX = (child % 2) * half;
+        int offsetY = (child / 2) * half;
+        for (int y = 0; y < half; ++y) {
+            for (int x = 0; x < half; ++x) {
+                const uint8_t* block[4] = {
+                        &source[((2 * y) * TILE_SIZE + 2 * x) * 3],
+                        &source[((2 * y) * TILE_SIZE + 2 * x + 1) * 3],
+                        &source[((2 * y + 1) * TILE_SIZE + 2 * x) * 3],
+                        &source[((2 * y + 1) * TILE_SIZE + 2 * x + 1) * 3]
+                };
+                uint8_t* pixel = &tile.pixels[((offsetY + y) * TILE_SIZE + offsetX + x) * 3];
+
+                const uint8_t* marker = nullptr;
+                for (const uint8_t* sample : block) {
+                    bool drone = sample[0] == 0 && sample[1] == 0 && sample[2] == 255;
+                    bool line = sample[0] == 255 && sample[1] == 0 && sample[2] == 0;
+                    if (drone || (line && marker == nullptr)) {
+                        marker = sample;
+                    }
+                }
+                for (int channel = 0; channel < 3; ++channel) {
+                    pixel[channel] = marker != nullptr ? marker[channel] :
+                            (block[0][channel] + block[1][channel] + block[2][channel] + block[3][channel] + 2) / 4;
+                }
+            }
+        }
+    }
+    return tile;
+}
+
+/**
+ * Builds a tile and every tile below it, depth first, writing the tiles that changed.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param connectedDrones Vector of pairs of connected drones.
+ * @param zoom The zoom level of the tile.
+ * @param x The column of the tile.
+ * @param y The row of the tile.
+ * @return The tile.
+ */
+PixelImage TileExporter::buildTile(const std::vector<Node*>& nodes,
+                                   const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                                   int zoom, int x, int y) {
+    PixelImage tile;
+    if (zoom == maxZoom) {
+        tile = renderTile(nodes, connectedDrones, x, y);
+    } else {
+        PixelImage children[4];
+        const PixelImage* present[4] = {nullptr, nullptr, nullptr, nullptr};
+        for (int child = 0; child < 4; ++child) {
+            int childX = 2 * x + child % 2;
+            int childY = 2 * y + child / 2;
+            if (childX < getTileCount(zoom + 1, true) && childY < getTileCount(zoom + 1, false)) {
+                children[child] = buildTile(nodes, connectedDrones, zoom + 1, childX, childY);
+                present[child] = &children[child];
+            }
+        }
+        tile = combineTiles(present);
+    }
+    writeTile(zoom, x, y, tile);
+    return tile;
+}
+
+/**
+ * Writes a tile to {directory}/{zoom}/{x}/{y}.bmp, unless the file already holds the same content. Tile viewers
+ * expect the first row at the top, so the rows are written from the bottom up.
+ *
+ * @param zoom The zoom level of the tile.
+ * @param x The column of the tile.
+ * @param y The row of the tile.
+ * @param tile The tile to write.
+ */
+void TileExporter::writeTile(int zoom, int x, int y, const PixelImage& tile) {
+    // FNV-1a hash of the tile content
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint8_t value : tile.pixels) {
+        hash = (hash ^ value) * 1099511628211ULL;
+    }
+
+    std::filesystem::path folder = std::filesystem::path(directory) / std::to_string(zoom) / std::to_string(x);
+    std::filesystem::path path = folder / (std::to_string(y) + ".bmp");
+    {
+        std::unique_lock<std::mutex> lock(hashMutex);
+        auto previous = tileHashes.find({zoom, x, y});
+        if (previous != tileHashes.end() && previous->second == hash && std::filesystem::exists(path)) {
+            return;
+        }
+        tileHashes[{zoom, x, y}] = hash;
+        tilesWritten++;
+    }
+
+    PixelImage flipped;
+    flipped.width = tile.width;
+    flipped.height = tile.height;
+    flipped.pixels.resize(tile.pixels.size());
+    size_t rowSize = static_cast<size_t>(tile.width) * 3;
+    for (int row = 0; row < tile.height; ++row) {
+        std::copy_n(&tile.pixels[rowSize * row], rowSize, &flipped.pixels[rowSize * (tile.height - 1 - row)]);
+    }
+
+    std::filesystem::create_directories(folder);
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Unable to open file: " << path.string() << std::endl;
+        return;
+    }
+    Topography::writeImageToBMP(flipped, file);
+}
+
+/**
+ * Exports the map as a tile pyramid. The tiles of the zoom level with a few tiles per thread are built in parallel,
+ * each together with all of the tiles below it, and the levels above are then combined from them.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param connectedDrones Vector of pairs of connected drones.
+ * @return The number of tiles that were written because their content changed.
+ */
+int TileExporter::exportTiles(const std::vector<Node*>& nodes,
+                              const std::vector<std::pair<Node*, Node*>>& connectedDrones) {
+    Viewport map = topography->clampViewport(Viewport());
+    mapWidth = map.width;
+    mapHeight = map.height;
+    maxZoom = 0;
+    while ((TILE_SIZE << maxZoom) < std::max(mapWidth, mapHeight)) {
+        maxZoom++;
+    }
+    tilesWritten = 0;
+
+    int splitZoom = 0;
+    while (splitZoom < maxZoom && getTileCount(splitZoom, true) * getTileCount(splitZoom, false) < 4 * numberOfThreads) {
+        splitZoom++;
+    }
+
+    int columns = getTileCount(splitZoom, true);
+    int rows = getTileCount(splitZoom, false);
+    std::vector<PixelImage> level(static_cast<size_t>(columns) * rows);
+    Workers workers(numberOfThreads);
+    workers.start();
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < columns; ++x) {
+            workers.post([this, &nodes, &connectedDrones, &level, splitZoom, columns, x, y] {
+                level[static_cast<size_t>(y) * columns + x] = buildTile(nodes, connectedDrones, splitZoom, x, y);
+            });
+        }
+    }
+    workers.stop();
+
+    for (int zoom = splitZoom - 1; zoom >= 0; --zoom) {
+        int parentColumns = getTileCount(zoom, true);
+        int parentRows = getTileCount(zoom, false);
+        std::vector<PixelImage> parents(static_cast<size_t>(parentColumns) * parentRows);
+        for (int y = 0; y < parentRows; ++y) {
+            for (int x = 0; x < parentColumns; ++x) {
+                const PixelImage* children[4] = {nullptr, nullptr, nullptr, nullptr};
+                for (int child = 0; child < 4; ++child) {
+                    int childX = 2 * x + child % 2;
+                    int childY = 2 * y + child / 2;
+                    if (childX < columns && childY < rows) {
+                        children[child] = &level[static_cast<size_t>(childY) * columns + childX];
+                    }
+                }
+                parents[static_cast<size_t>(y) * parentColumns + x] = combineTiles(children);
+                writeTile(zoom, x, y, parents[static_cast<size_t>(y) * parentColumns + x]);
+            }
+        }
+        level = std::move(parents);
+        columns = parentColumns;
+        rows = parentRows;
+    }
+
+    return tilesWritten;
+}
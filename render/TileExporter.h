@@ -0,0 +1,52 @@
+#ifndef TILEEXPORTER_H
+#define TILEEXPORTER_H
+
+#include "../node/Node.h"
+#include "../topography/Topography.h"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Exports the rendered map as a pyramid of 256x256 tiles in the {z}/{x}/{y}.bmp layout used by XYZ tile viewers. The
+// highest zoom level shows the map at full size, and every level above it is built by downsampling the four tiles
+// below it, so the full map is never held in memory at once. Tiles are only written when their content changed since
+// the previous export.
+class TileExporter {
+private:
+    Topography* topography;
+    std::string directory;
+    int numberOfThreads;
+    std::map<std::tuple<int, int, int>, uint64_t> tileHashes;
+    std::mutex hashMutex;
+    int mapWidth = 0;
+    int mapHeight = 0;
+    int maxZoom = 0;
+    int tilesWritten = 0;
+
+    int getTileCount(int zoom, bool horizontal) const;
+
+    PixelImage renderTile(const std::vector<Node*>& nodes, const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                          int x, int y);
+
+    PixelImage combineTiles(const PixelImage* children[4]);
+
+    PixelImage buildTile(const std::vector<Node*>& nodes, const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                         int zoom, int x, int y);
+
+    void writeTile(int zoom, int x, int y, const PixelImage& tile);
+
+public:
+    static constexpr int TILE_SIZE = 256;
+
+    TileExporter(Topography* topography, std::string directory, int numberOfThreads);
+
+    int getMaxZoom() const;
+
+    int exportTiles(const std::vector<Node*>& nodes, const std::vector<std::pair<Node*, Node*>>& connectedDrones);
+};
+
+#endif // TILEEXPORTER_H
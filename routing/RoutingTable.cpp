@@ -0,0 +1,651 @@
+#include "RoutingTable.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * Returns the number of hops of a route through the neighbor that advertised it. Broken routes stay broken instead of
+ * wrapping around to 0 hops.
+ *
+ * @param advertisedHops The number of hops advertised by the neighbor.
+ * @return The number of hops through the neighbor.
+ */
+static uint16_t hopsThroughNeighbor(uint16_t advertisedHops) {
+    return advertisedHops == RouteEntry::INFINITE_HOPS ? RouteEntry::INFINITE_HOPS : advertisedHops + 1;
+}
+
+/**
+ * Stores the route to a destination, growing the table if the destination is beyond the last slot. Setting an entry
+ * with NO_NEXT_HOP forgets the destination.
+ *
+ * @param destination The id of the destination node.
+ * @param entry The route to the destination.
+ */
+void DenseRoutingTable::set(int destination, const RouteEntry& entry) {
+    if (destination < 0) {
+        return;
+    }
+    if (destination >= static_cast<int>(nextHops.size())) {
+        if (entry.nextHop == RouteEntry::NO_NEXT_HOP) {
+            return;
+        }
+        nextHops.resize(destination + 1, RouteEntry::NO_NEXT_HOP);
+        hopCounts.resize(destination + 1, RouteEntry::INFINITE_HOPS);
+        sequenceNumbers.resize(destination + 1, RouteEntry::NO_SEQUENCE_NUMBER);
+    }
+    bool wasKnown = nextHops[destination] != RouteEntry::NO_NEXT_HOP;
+    bool isKnown = entry.nextHop != RouteEntry::NO_NEXT_HOP;
+    knownDestinations += static_cast<int>(isKnown) - static_cast<int>(wasKnown);
+    nextHops[destination] = entry.nextHop;
+    hopCounts[destination] = entry.hops;
+    sequenceNumbers[destination] = entry.sequenceNumber;
+}
+
+/**
+ * Merges one route received from a neighbor into the route of this table to the same destination. The received route
+ * is taken if the destination is new, if its sequence number is higher, or if the sequence number is the same and the
+ * route through the neighbor is shorter.
+ *
+ * @param nextHop The next hop of this table, NO_NEXT_HOP if the destination is unknown.
+ * @param hopCount The number of hops of this table.
+ * @param sequenceNumber The sequence number of this table.
+ * @param advertisedHops The number of hops advertised by the neighbor.
+ * @param receivedSequenceNumber The sequence number advertised by the neighbor.
+ * @param neighborId The id of the neighbor.
+ * @return Whether the destination was added or got a new next hop or hop count.
+ */
+static bool mergeRoute(int32_t& nextHop, uint16_t& hopCount, int32_t& sequenceNumber, uint16_t advertisedHops,
+                       int32_t receivedSequenceNumber, int neighborId) {
+    uint16_t hops = hopsThroughNeighbor(advertisedHops);
+    bool known = nextHop != RouteEntry::NO_NEXT_HOP;
+    if (known && receivedSequenceNumber < sequenceNumber) {
+        return false;
+    }
+    if (known && receivedSequenceNumber == sequenceNumber && hops >= hopCount) {
+        return false;
+    }
+    bool changed = !known || nextHop != neighborId || hopCount != hops;
+    nextHop = neighborId;
+    hopCount = hops;
+    sequenceNumber = receivedSequenceNumber;
+    return changed;
+}
+
+/**
+ * Handles a route to the node itself in a received table. The own route is never replaced, since no route through a
+ * neighbor is better than the node itself. A newer sequence number for the node can only be an odd one, sent by a
+ * neighbor that saw its routes to the node break. As in DSDV, the node then moves its own sequence number to the next
+ * even number above it, so its next broadcast replaces the broken routes.
+ *
+ * @param sequenceNumber The sequence number of the own route.
+ * @param receivedSequenceNumber The sequence number advertised by the neighbor.
+ */
+static void raiseOwnSequenceNumber(int32_t& sequenceNumber, int32_t receivedSequenceNumber) {
+    if (receivedSequenceNumber > sequenceNumber) {
+        sequenceNumber = (receivedSequenceNumber | 1) + 1;
+    }
+}
+
+/**
+ * Merges received routes into the arrays of a dense table with the DSDV acceptance rule, one destination at a time.
+ *
+ * @param received The next hops, hop counts and sequence numbers received from the neighbor.
+ * @param own The next hops, hop counts and sequence numbers of the table to merge into.
+ * @param begin The first destination to merge.
+ * @param end One past the last destination to merge.
+ * @param neighborId The id of the neighbor.
+ * @param added Increased by the number of destinations that were unknown before.
+ * @param changedDestinations If not null, the destinations that were added or changed are appended to it.
+ * @return The number of destinations that were added or got a new next hop or hop count.
+ */
+static int mergeRoutesScalar(const int32_t* receivedNextHops, const uint16_t* receivedHops,
+                             const int32_t* receivedSequenceNumbers, int32_t* nextHops, uint16_t* hopCounts,
+                             int32_t* sequenceNumbers, int begin, int end, int neighborId, int& added,
+                             std::vector<int32_t>* changedDestinations) {
+    int changes = 0;
+    for (int destination = begin; destination < end; ++destination) {
+        if (receivedNextHops[destination] == RouteEntry::NO_NEXT_HOP) {
+            continue;
+        }
+        bool known = nextHops[destination] != RouteEntry::NO_NEXT_HOP;
+        if (mergeRoute(nextHops[destination], hopCounts[destination], sequenceNumbers[destination],
+                       receivedHops[destination], receivedSequenceNumbers[destination], neighborId)) {
+            changes++;
+            added += static_cast<int>(!known);
+            if (changedDestinations != nullptr) {
+                changedDestinations->push_back(destination);
+            }
+        }
+    }
+    return changes;
+}
+
+#if defined(__AVX2__) || defined(__SSE2__)
+/**
+ * Appends the destinations of the set lanes of a mask of 16-bit lanes, where every lane sets two bits.
+ *
+ * @param laneBits The result of movemask on the mask.
+ * @param first The destination of the first lane.
+ * @param changedDestinations The list to append to.
+ */
+void appendSetLanes(unsigned laneBits, int first, std::vector<int32_t>& changedDestinations) {
+    while (laneBits != 0) {
+        int bit = __builtin_ctz(laneBits);
+        changedDestinations.push_back(first + bit / 2);
+        laneBits &= ~(3u << bit);
+    }
+}
+#endif
+
+#if defined(__AVX2__)
+/**
+ * Merges received routes with the DSDV acceptance rule, 16 destinations at a time with AVX2. The rule is evaluated
+ * without branches: the hop counts are compared in 16-bit lanes, the sequence numbers and next hops in 32-bit lanes,
+ * and the masks are packed or widened between the two lane sizes. Blocks without any accepted route are not written.
+ * The parameters and the result are the same as for mergeRoutesScalar(), and begin is returned past the last full
+ * block.
+ */
+static int mergeRoutesVectorized(const int32_t* receivedNextHops, const uint16_t* receivedHops,
+                                 const int32_t* receivedSequenceNumbers, int32_t* nextHops, uint16_t* hopCounts,
+                                 int32_t* sequenceNumbers, int& begin, int end, int neighborId, int& added,
+                                 std::vector<int32_t>* changedDestinations) {
+    const __m256i unknown = _mm256_set1_epi32(RouteEntry::NO_NEXT_HOP);
+    const __m256i neighbor = _mm256_set1_epi32(neighborId);
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+    int changes = 0;
+    int destination = begin;
+    for (; destination + 16 <= end; destination += 16) {
+        auto load = [](const void* address) {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(address));
+        };
+        __m256i receivedNextLow = load(receivedNextHops + destination);
+        __m256i receivedNextHigh = load(receivedNextHops + destination + 8);
+        __m256i receivedSequenceLow = load(receivedSequenceNumbers + destination);
+        __m256i receivedSequenceHigh = load(receivedSequenceNumbers + destination + 8);
+        __m256i ownNextLow = load(nextHops + destination);
+        __m256i ownNextHigh = load(nextHops + destination + 8);
+        __m256i ownSequenceLow = load(sequenceNumbers + destination);
+        __m256i ownSequenceHigh = load(sequenceNumbers + destination + 8);
+        __m256i ownHops = load(hopCounts + destination);
+        __m256i hops = _mm256_adds_epu16(load(receivedHops + destination), one);
+
+        // Masks in 32-bit lanes, packed to 16-bit lanes in destination order
+        auto pack = [](__m256i low, __m256i high) {
+            return _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+        };
+        __m256i receivedKnown = _mm256_xor_si256(pack(_mm256_cmpeq_epi32(receivedNextLow, unknown),
+                                                      _mm256_cmpeq_epi32(receivedNextHigh, unknown)),
+                                                 _mm256_set1_epi16(-1));
+        __m256i ownUnknown = pack(_mm256_cmpeq_epi32(ownNextLow, unknown), _mm256_cmpeq_epi32(ownNextHigh, unknown));
+        __m256i newer = pack(_mm256_cmpgt_epi32(receivedSequenceLow, ownSequenceLow),
+                             _mm256_cmpgt_epi32(receivedSequenceHigh, ownSequenceHigh));
+        __m256i same = pack(_mm256_cmpeq_epi32(receivedSequenceLow, ownSequenceLow),
+                            _mm256_cmpeq_epi32(receivedSequenceHigh, ownSequenceHigh));
+        __m256i otherNextHop = _mm256_xor_si256(pack(_mm256_cmpeq_epi32(ownNextLow, neighbor),
+                                                     _mm256_cmpeq_epi32(ownNextHigh, neighbor)),
+                                                _mm256_set1_epi16(-1));
+
+        // Unsigned 16-bit compares: ownHops > hops when the saturated difference is not zero
+        __m256i fewerHops = _mm256_xor_si256(_mm256_cmpeq_epi16(_mm256_subs_epu16(ownHops, hops), zero),
+                                             _mm256_set1_epi16(-1));
+        __m256i otherHops = _mm256_xor_si256(_mm256_cmpeq_epi16(ownHops, hops), _mm256_set1_epi16(-1));
+
+        __m256i accepted = _mm256_and_si256(receivedKnown, _mm256_or_si256(
+                _mm256_or_si256(ownUnknown, newer), _mm256_and_si256(same, fewerHops)));
+        unsigned acceptedBits = static_cast<unsigned>(_mm256_movemask_epi8(accepted));
+        if (acceptedBits == 0) {
+            continue;
+        }
+        __m256i changed = _mm256_and_si256(accepted, _mm256_or_si256(ownUnknown,
+                                                                     _mm256_or_si256(otherNextHop, otherHops)));
+        __m256i addedRoutes = _mm256_and_si256(accepted, ownUnknown);
+        unsigned changedBits = static_cast<unsigned>(_mm256_movemask_epi8(changed));
+        changes += __builtin_popcount(changedBits) / 2;
+        if (changedDestinations != nullptr) {
+            appendSetLanes(changedBits, destination, *changedDestinations);
+        }
+        added += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(addedRoutes))) / 2;
+
+        // Widen the mask back to 32-bit lanes and select between the own and the received values
+        __m256i acceptedLow = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(accepted));
+        __m256i acceptedHigh = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(accepted, 1));
+        auto store = [](void* address, __m256i value) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(address), value);
+        };
+        store(nextHops + destination, _mm256_blendv_epi8(ownNextLow, neighbor, acceptedLow));
+        store(nextHops + destination + 8, _mm256_blendv_epi8(ownNextHigh, neighbor, acceptedHigh));
+        store(sequenceNumbers + destination, _mm256_blendv_epi8(ownSequenceLow, receivedSequenceLow, acceptedLow));
+        store(sequenceNumbers + destination + 8,
+              _mm256_blendv_epi8(ownSequenceHigh, receivedSequenceHigh, acceptedHigh));
+        store(hopCounts + destination, _mm256_blendv_epi8(ownHops, hops, accepted));
+    }
+    begin = destination;
+    return changes;
+}
+#elif defined(__SSE2__)
+/**
+ * Merges received routes with the DSDV acceptance rule, 8 destinations at a time with SSE2. The rule is evaluated
+ * without branches: the hop counts are compared in 16-bit lanes, the sequence numbers and next hops in 32-bit lanes,
+ * and the masks are packed or widened between the two lane sizes. Blocks without any accepted route are not written.
+ * The parameters and the result are the same as for mergeRoutesScalar(), and begin is returned past the last full
+ * block.
+ */
+static int mergeRoutesVectorized(const int32_t* receivedNextHops, const uint16_t* receivedHops,
+                                 const int32_t* receivedSequenceNumbers, int32_t* nextHops, uint16_t* hopCounts,
+                                 int32_t* sequenceNumbers, int& begin, int end, int neighborId, int& added,
+                                 std::vector<int32_t>* changedDestinations) {
+    const __m128i unknown = _mm_set1_epi32(RouteEntry::NO_NEXT_HOP);
+    const __m128i neighbor = _mm_set1_epi32(neighborId);
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i allOnes = _mm_set1_epi16(-1);
+    int changes = 0;
+    int destination = begin;
+    for (; destination + 8 <= end; destination += 8) {
+        auto load = [](const void* address) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(address));
+        };
+        __m128i receivedNextLow = load(receivedNextHops + destination);
+        __m128i receivedNextHigh = load(receivedNextHops + destination + 4);
+        __m128i receivedSequenceLow = load(receivedSequenceNumbers + destination);
+        __m128i receivedSequenceHigh = load(receivedSequenceNumbers + destination + 4);
+        __m128i ownNextLow = load(nextHops + destination);
+        __m128i ownNextHigh = load(nextHops + destination + 4);
+        __m128i ownSequenceLow = load(sequenceNumbers + destination);
+        __m128i ownSequenceHigh = load(sequenceNumbers + destination + 4);
+        __m128i ownHops = load(hopCounts + destination);
+        __m128i hops = _mm_adds_epu16(load(receivedHops + destination), one);
+
+        // Masks in 32-bit lanes, packed to 16-bit lanes
+        __m128i receivedKnown = _mm_xor_si128(_mm_packs_epi32(_mm_cmpeq_epi32(receivedNextLow, unknown),
+                                                              _mm_cmpeq_epi32(receivedNextHigh, unknown)), allOnes);
+        __m128i ownUnknown = _mm_packs_epi32(_mm_cmpeq_epi32(ownNextLow, unknown),
+                                             _mm_cmpeq_epi32(ownNextHigh, unknown));
+        __m128i newer = _mm_packs_epi32(_mm_cmpgt_epi32(receivedSequenceLow, ownSequenceLow),
+                                        _mm_cmpgt_epi32(receivedSequenceHigh, ownSequenceHigh));
+        __m128i same = _mm_packs_epi32(_mm_cmpeq_epi32(receivedSequenceLow, ownSequenceLow),
+                                       _mm_cmpeq_epi32(receivedSequenceHigh, ownSequenceHigh));
+        __m128i otherNextHop = _mm_xor_si128(_mm_packs_epi32(_mm_cmpeq_epi32(ownNextLow, neighbor),
+                                                             _mm_cmpeq_epi32(ownNextHigh, neighbor)), allOnes);
+
+        // Unsigned 16-bit compares: ownHops > hops when the saturated difference is not zero
+        __m128i fewerHops = _mm_xor_si128(_mm_cmpeq_epi16(_mm_subs_epu16(ownHops, hops), zero), allOnes);
+        __m128i otherHops = _mm_xor_si128(_mm_cmpeq_epi16(ownHops, hops), allOnes);
+
+        __m128i accepted = _mm_and_si128(receivedKnown, _mm_or_si128(_mm_or_si128(ownUnknown, newer),
+                                                                     _mm_and_si128(same, fewerHops)));
+        if (_mm_movemask_epi8(accepted) == 0) {
+            continue;
+        }
+        __m128i changed = _mm_and_si128(accepted, _mm_or_si128(ownUnknown, _mm_or_si128(otherNextHop, otherHops)));
+        unsigned changedBits = static_cast<unsigned>(_mm_movemask_epi8(changed));
+        changes += __builtin_popcount(changedBits) / 2;
+        if (changedDestinations != nullptr) {
+            appendSetLanes(changedBits, destination, *changedDestinations);
+        }
+        added += __builtin_popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(accepted, ownUnknown)))) / 2;
+
+        // Widen the mask back to 32-bit lanes and select between the own and the received values
+        __m128i acceptedLow = _mm_unpacklo_epi16(accepted, accepted);
+        __m128i acceptedHigh = _mm_unpackhi_epi16(accepted, accepted);
+        auto select = [](__m128i own, __m128i received, __m128i mask) {
+            return _mm_or_si128(_mm_andnot_si128(mask, own), _mm_and_si128(mask, received));
+        };
+        auto store = [](void* address, __m128i value) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(address), value);
+        };
+        store(nextHops + destination, select(ownNextLow, neighbor, acceptedLow));
+        store(nextHops + destination + 4, select(ownNextHigh, neighbor, acceptedHigh));
+        store(sequenceNumbers + destination, select(ownSequenceLow, receivedSequenceLow, acceptedLow));
+        store(sequenceNumbers + destination + 4, select(ownSequenceHigh, receivedSequenceHigh, acceptedHigh));
+        store(hopCounts + destination, select(ownHops, hops, accepted));
+    }
+    begin = destination;
+    return changes;
+}
+#endif
+
+/**
+ * Merges a routing table received from a neighbor into this table, in place and in a single pass over both tables. A
+ * received route is taken if the destination is new, if its sequence number is higher, or if the sequence number is the
+ * same and the route through the neighbor is shorter. With AVX2 or SSE2, 16 or 8 destinations are merged at a time, and
+ * the remaining destinations one at a time. The own route of the node is left out of the merge, so the destinations
+ * before and after it are merged as two ranges.
+ *
+ * @param received The routing table of the neighbor.
+ * @param neighborId The id of the neighbor.
+ * @param ownId The id of the node the table belongs to, or NO_OWN_ID.
+ * @param changedDestinations If not null, the destinations that were added or changed are appended to it.
+ * @param vectorized Whether to use the SIMD merge when it is available. The result is the same either way.
+ * @return The number of destinations that were added or got a new next hop or hop count. Routes that only got a newer
+ *         sequence number are not counted, so the result is 0 once the routes have converged.
+ */
+int DenseRoutingTable::merge(const DenseRoutingTable& received, int neighborId, int ownId,
+                             std::vector<int32_t>* changedDestinations, bool vectorized) {
+    int count = static_cast<int>(received.nextHops.size());
+    if (count > static_cast<int>(nextHops.size())) {
+        nextHops.resize(count, RouteEntry::NO_NEXT_HOP);
+        hopCounts.resize(count, RouteEntry::INFINITE_HOPS);
+        sequenceNumbers.resize(count, RouteEntry::NO_SEQUENCE_NUMBER);
+    }
+
+    int changes = 0;
+    int added = 0;
+    auto mergeRange = [&](int destination, int end) {
+#if defined(__AVX2__) || defined(__SSE2__)
+        if (vectorized) {
+            changes += mergeRoutesVectorized(received.nextHops.data(), received.hopCounts.data(),
+                                             received.sequenceNumbers.data(), nextHops.data(), hopCounts.data(),
+                                             sequenceNumbers.data(), destination, end, neighborId, added,
+                                             changedDestinations);
+        }
+#endif
+        changes += mergeRoutesScalar(received.nextHops.data(), received.hopCounts.data(),
+                                     received.sequenceNumbers.data(), nextHops.data(), hopCounts.data(),
+                                     sequenceNumbers.data(), destination, end, neighborId, added, changedDestinations);
+    };
+    if (ownId >= 0 && ownId < count) {
+        mergeRange(0, ownId);
+        if (received.nextHops[ownId] != RouteEntry::NO_NEXT_HOP) {
+            raiseOwnSequenceNumber(sequenceNumbers[ownId], received.sequenceNumbers[ownId]);
+        }
+        mergeRange(ownId + 1, count);
+    } else {
+        mergeRange(0, count);
+    }
+    knownDestinations += added;
+    return changes;
+}
+
+/**
+ * Merges an incremental update received from a neighbor into this table, with the same rules as the merge of a full
+ * table. Only the destinations in the update are visited.
+ *
+ * @param updates The routes that changed in the table of the neighbor.
+ * @param neighborId The id of the neighbor.
+ * @param ownId The id of the node the table belongs to, or NO_OWN_ID. The own route is never replaced.
+ * @param changedDestinations If not null, the destinations that were added or changed are appended to it.
+ * @return The number of destinations that were added or got a new next hop or hop count.
+ */
+int DenseRoutingTable::merge(const std::vector<RouteUpdate>& updates, int neighborId, int ownId,
+                             std::vector<int32_t>* changedDestinations) {
+    int changes = 0;
+    for (const RouteUpdate& update : updates) {
+        int destination = update.destination;
+        if (destination < 0 || update.entry.nextHop == RouteEntry::NO_NEXT_HOP) {
+            continue;
+        }
+        if (destination == ownId) {
+            if (destination < static_cast<int>(sequenceNumbers.size())) {
+                raiseOwnSequenceNumber(sequenceNumbers[destination], update.entry.sequenceNumber);
+            }
+            continue;
+        }
+        if (destination >= static_cast<int>(nextHops.size())) {
+            nextHops.resize(destination + 1, RouteEntry::NO_NEXT_HOP);
+            hopCounts.resize(destination + 1, RouteEntry::INFINITE_HOPS);
+            sequenceNumbers.resize(destination + 1, RouteEntry::NO_SEQUENCE_NUMBER);
+        }
+        bool known = nextHops[destination] != RouteEntry::NO_NEXT_HOP;
+        if (mergeRoute(nextHops[destination], hopCounts[destination], sequenceNumbers[destination], update.entry.hops,
+                       update.entry.sequenceNumber, neighborId)) {
+            changes++;
+            knownDestinations += static_cast<int>(!known);
+            if (changedDestinations != nullptr) {
+                changedDestinations->push_back(destination);
+            }
+        }
+    }
+    return changes;
+}
+
+/**
+ * Marks every route through a neighbor as broken, after nothing was heard from the neighbor for too long. As in DSDV,
+ * a broken route gets INFINITE_HOPS and the next odd sequence number, so it replaces the old route at the nodes it is
+ * advertised to, and is itself replaced by the next route with a newer even sequence number from the destination.
+ *
+ * @param neighborId The id of the neighbor.
+ * @param changedDestinations If not null, the destinations whose routes broke are appended to it.
+ * @return The number of routes that broke.
+ */
+int DenseRoutingTable::expireRoutesThrough(int neighborId, std::vector<int32_t>* changedDestinations) {
+    int expired = 0;
+    for (int destination = 0; destination < static_cast<int>(nextHops.size()); ++destination) {
+        if (nextHops[destination] == neighborId && hopCounts[destination] != RouteEntry::INFINITE_HOPS) {
+            hopCounts[destination] = RouteEntry::INFINITE_HOPS;
+            sequenceNumbers[destination] |= 1;
+            expired++;
+            if (changedDestinations != nullptr) {
+                changedDestinations->push_back(destination);
+            }
+        }
+    }
+    return expired;
+}
+
+/**
+ * Stores the route to a destination, inserting it in order if it is new. Setting an entry with NO_NEXT_HOP removes
+ * the destination.
+ *
+ * @param destination The id of the destination node.
+ * @param entry The route to the destination.
+ */
+void SparseRoutingTable::set(int destination, const RouteEntry& entry) {
+    size_t index = find(destination);
+    bool exists = index < destinations.size() && destinations[index] == destination;
+    if (entry.nextHop == RouteEntry::NO_NEXT_HOP) {
+        if (exists) {
+            destinations.erase(destinations.begin() + index);
+            nextHops.erase(nextHops.begin() + index);
+            hopCounts.erase(hopCounts.begin() + index);
+            sequenceNumbers.erase(sequenceNumbers.begin() + index);
+        }
+        return;
+    }
+    if (!exists) {
+        destinations.insert(destinations.begin() + index, destination);
+        nextHops.insert(nextHops.begin() + index, entry.nextHop);
+        hopCounts.insert(hopCounts.begin() + index, entry.hops);
+        sequenceNumbers.insert(sequenceNumbers.begin() + index, entry.sequenceNumber);
+        return;
+    }
+    nextHops[index] = entry.nextHop;
+    hopCounts[index] = entry.hops;
+    sequenceNumbers[index] = entry.sequenceNumber;
+}
+
+/**
+ * Merges a routing table received from a neighbor into this table, with the same rules as DenseRoutingTable::merge().
+ * Both tables are sorted by destination, so they are walked side by side. If the neighbor knows destinations that this
+ * table does not, the merged table is built in new arrays, otherwise the entries are updated in place.
+ *
+ * @param received The routing table of the neighbor.
+ * @param neighborId The id of the neighbor.
+ * @param ownId The id of the node the table belongs to, or NO_OWN_ID. The own route is never replaced.
+ * @param changedDestinations If not null, the destinations that were added or changed are appended to it.
+ * @return The number of destinations that were added or got a new next hop or hop count.
+ */
+int SparseRoutingTable::merge(const SparseRoutingTable& received, int neighborId, int ownId,
+                              std::vector<int32_t>* changedDestinations) {
+    size_t newDestinations = 0;
+    for (size_t own = 0, other = 0; other < received.destinations.size(); ++other) {
+        while (own < destinations.size() && destinations[own] < received.destinations[other]) {
+            own++;
+        }
+        if ((own == destinations.size() || destinations[own] != received.destinations[other]) &&
+            received.destinations[other] != ownId) {
+            newDestinations++;
+        }
+    }
+
+    SparseRoutingTable merged;
+    if (newDestinations > 0) {
+        size_t size = destinations.size() + newDestinations;
+        merged.destinations.reserve(size);
+        merged.nextHops.reserve(size);
+        merged.hopCounts.reserve(size);
+        merged.sequenceNumbers.reserve(size);
+    }
+    auto append = [&](int32_t destination, int32_t nextHop, uint16_t hops, int32_t sequenceNumber) {
+        merged.destinations.push_back(destination);
+        merged.nextHops.push_back(nextHop);
+        merged.hopCounts.push_back(hops);
+        merged.sequenceNumbers.push_back(sequenceNumber);
+    };
+
+    int changes = 0;
+    size_t own = 0;
+    for (size_t other = 0; other < received.destinations.size(); ++other) {
+        int32_t destination = received.destinations[other];
+        while (own < destinations.size() && destinations[own] < destination) {
+            if (newDestinations > 0) {
+                append(destinations[own], nextHops[own], hopCounts[own], sequenceNumbers[own]);
+            }
+            own++;
+        }
+        uint16_t hops = hopsThroughNeighbor(received.hopCounts[other]);
+        int32_t sequenceNumber = received.sequenceNumbers[other];
+        if (own == destinations.size() || destinations[own] != destination) {
+            if (destination == ownId) {
+                continue;
+            }
+            append(destination, neighborId, hops, sequenceNumber);
+            changes++;
+            if (changedDestinations != nullptr) {
+                changedDestinations->push_back(destination);
+            }
+            continue;
+        }
+
+        bool accepted = sequenceNumber > sequenceNumbers[own] ||
+                        (sequenceNumber == sequenceNumbers[own] && hops < hopCounts[own]);
+        if (destination == ownId) {
+            raiseOwnSequenceNumber(sequenceNumbers[own], sequenceNumber);
+            accepted = false;
+        }
+        if (accepted && (nextHops[own] != neighborId || hopCounts[own] != hops)) {
+            changes++;
+            if (changedDestinations != nullptr) {
+                changedDestinations->push_back(destination);
+            }
+        }
+        if (newDestinations > 0) {
+            append(destination, accepted ? neighborId : nextHops[own], accepted ? hops : hopCounts[own],
+                   accepted ? sequenceNumber : sequenceNumbers[own]);
+        } else if (accepted) {
+            nextHops[own] = neighborId;
+            hopCounts[own] = hops;
+            sequenceNumbers[own] = sequenceNumber;
+        }
+        own++;
+    }
+
+    if (newDestinations > 0) {
+        for (; own < destinations.size(); ++own) {
+            append(destinations[own], nextHops[own], hopCounts[own], sequenceNumbers[own]);
+        }
+        *this = std::move(merged);
+    }
+    return changes;
+}
+
+/**
+ * Merges an incremental update received from a neighbor into this table, with the same rules as the merge of a full
+ * table. Known destinations are looked up and updated in place. New destinations are collected and merged into the
+ * arrays in one pass at the end, so an update with many new routes does not insert them one by one.
+ *
+ * @param updates The routes that changed in the table of the neighbor.
+ * @param neighborId The id of the neighbor.
+ * @param ownId The id of the node the table belongs to, or NO_OWN_ID. The own route is never replaced.
+ * @param changedDestinations If not null, the destinations that were added or changed are appended to it.
+ * @return The number of destinations that were added or got a new next hop or hop count.
+ */
+int SparseRoutingTable::merge(const std::vector<RouteUpdate>& updates, int neighborId, int ownId,
+                              std::vector<int32_t>* changedDestinations) {
+    int changes = 0;
+    SparseRoutingTable added;
+    for (const RouteUpdate& update : updates) {
+        int destination = update.destination;
+        if (update.entry.nextHop == RouteEntry::NO_NEXT_HOP) {
+            continue;
+        }
+        size_t index = find(destination);
+        bool exists = index < destinations.size() && destinations[index] == destination;
+        if (destination == ownId) {
+            if (exists) {
+                raiseOwnSequenceNumber(sequenceNumbers[index], update.entry.sequenceNumber);
+            }
+            continue;
+        }
+        bool changed;
+        if (exists) {
+            changed = mergeRoute(nextHops[index], hopCounts[index], sequenceNumbers[index], update.entry.hops,
+                                 update.entry.sequenceNumber, neighborId);
+        } else {
+            RouteEntry route = added.get(destination);
+            changed = mergeRoute(route.nextHop, route.hops, route.sequenceNumber, update.entry.hops,
+                                 update.entry.sequenceNumber, neighborId);
+            if (changed) {
+                added.set(destination, route);
+            }
+        }
+        if (changed) {
+            changes++;
+            if (changedDestinations != nullptr) {
+                changedDestinations->push_back(destination);
+            }
+        }
+    }
+
+    if (added.size() > 0) {
+        SparseRoutingTable merged;
+        size_t size = destinations.size() + added.destinations.size();
+        merged.destinations.reserve(size);
+        merged.nextHops.reserve(size);
+        merged.hopCounts.reserve(size);
+        merged.sequenceNumbers.reserve(size);
+        auto append = [&merged](const SparseRoutingTable& source, size_t index) {
+            merged.destinations.push_back(source.destinations[index]);
+            merged.nextHops.push_back(source.nextHops[index]);
+            merged.hopCounts.push_back(source.hopCounts[index]);
+            merged.sequenceNumbers.push_back(source.sequenceNumbers[index]);
+        };
+        size_t own = 0;
+        for (size_t other = 0; other < added.destinations.size(); ++other) {
+            while (own < destinations.size() && destinations[own] < added.destinations[other]) {
+                append(*this, own++);
+            }
+            append(added, other);
+        }
+        for (; own < destinations.size(); ++own) {
+            append(*this, own);
+        }
+        *this = std::move(merged);
+    }
+    return changes;
+}
+
+/**
+ * Marks every route through a neighbor as broken, in the same way as DenseRoutingTable::expireRoutesThrough().
+ *
+ * @param neighborId The id of the neighbor.
+ * @param changedDestinations If not null, the destinations whose routes broke are appended to it.
+ * @return The number of routes that broke.
+ */
+int SparseRoutingTable::expireRoutesThrough(int neighborId, std::vector<int32_t>* changedDestinations) {
+    int expired = 0;
+    for (size_t index = 0; index < destinations.size(); ++index) {
+        if (nextHops[index] == neighborId && hopCounts[index] != RouteEntry::INFINITE_HOPS) {
+            hopCounts[index] = RouteEntry::INFINITE_HOPS;
+            sequenceNumbers[index] |= 1;
+            expired++;
+            if (changedDestinations != nullptr) {
+                changedDestinations->push_back(destinations[index]);
+            }
+        }
+    }
+    return expired;
+}
@@ -0,0 +1,160 @@
+#ifndef ROUTINGTABLE_H
+#define ROUTINGTABLE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// The route to one destination. A route with INFINITE_HOPS is known, but broken.
+struct RouteEntry {
+    static constexpr int32_t NO_NEXT_HOP = -1;
+    static constexpr uint16_t INFINITE_HOPS = 0xFFFF;
+    static constexpr int32_t NO_SEQUENCE_NUMBER = -1;
+
+    int32_t nextHop = NO_NEXT_HOP;
+    uint16_t hops = INFINITE_HOPS;
+    int32_t sequenceNumber = NO_SEQUENCE_NUMBER;
+};
+
+// The own id to pass to a merge into a table that does not belong to a node, so no route is kept out of the merge
+constexpr int NO_OWN_ID = -1;
+
+// One route in an incremental update, which only carries the routes that changed since the last full dump
+struct RouteUpdate {
+    int32_t destination;
+    RouteEntry entry;
+};
+
+// A routing table with a slot for every node id up to the highest known destination. The next hops, hop counts and
+// sequence numbers are stored in three separate arrays, so a lookup is a single index and a merge streams through
+// contiguous memory. Unknown destinations have NO_NEXT_HOP.
+class DenseRoutingTable {
+private:
+    std::vector<int32_t> nextHops;
+    std::vector<uint16_t> hopCounts;
+    std::vector<int32_t> sequenceNumbers;
+    int knownDestinations = 0;
+
+public:
+    bool contains(int destination) const;
+
+    RouteEntry get(int destination) const;
+
+    void set(int destination, const RouteEntry& entry);
+
+    int merge(const DenseRoutingTable& received, int neighborId, int ownId,
+              std::vector<int32_t>* changedDestinations = nullptr, bool vectorized = true);
+
+    int merge(const std::vector<RouteUpdate>& updates, int neighborId, int ownId,
+              std::vector<int32_t>* changedDestinations = nullptr);
+
+    int expireRoutesThrough(int neighborId, std::vector<int32_t>* changedDestinations = nullptr);
+
+    int size() const;
+
+    template<typename Function>
+    void forEach(Function function) const;
+};
+
+// A routing table that only stores the known destinations, sorted by id, in three parallel arrays. Lookups are binary
+// searches. Uses less memory than DenseRoutingTable in large networks where every node only knows a few destinations.
+class SparseRoutingTable {
+private:
+    std::vector<int32_t> destinations;
+    std::vector<int32_t> nextHops;
+    std::vector<uint16_t> hopCounts;
+    std::vector<int32_t> sequenceNumbers;
+
+    size_t find(int destination) const;
+
+public:
+    bool contains(int destination) const;
+
+    RouteEntry get(int destination) const;
+
+    void set(int destination, const RouteEntry& entry);
+
+    int merge(const SparseRoutingTable& received, int neighborId, int ownId,
+              std::vector<int32_t>* changedDestinations = nullptr);
+
+    int merge(const std::vector<RouteUpdate>& updates, int neighborId, int ownId,
+              std::vector<int32_t>* changedDestinations = nullptr);
+
+    int expireRoutesThrough(int neighborId, std::vector<int32_t>* changedDestinations = nullptr);
+
+    int size() const;
+
+    template<typename Function>
+    void forEach(Function function) const;
+};
+
+// The dense table is the default. Build with SPARSE_ROUTING_TABLE defined to use the sparse table instead.
+#ifdef SPARSE_ROUTING_TABLE
+using RoutingTable = SparseRoutingTable;
+#else
+using RoutingTable = DenseRoutingTable;
+#endif
+
+inline bool DenseRoutingTable::contains(int destination) const {
+    return destination >= 0 && destination < static_cast<int>(nextHops.size()) &&
+           nextHops[destination] != RouteEntry::NO_NEXT_HOP;
+}
+
+inline RouteEntry DenseRoutingTable::get(int destination) const {
+    RouteEntry entry;
+    if (destination >= 0 && destination < static_cast<int>(nextHops.size())) {
+        entry.nextHop = nextHops[destination];
+        entry.hops = hopCounts[destination];
+        entry.sequenceNumber = sequenceNumbers[destination];
+    }
+    return entry;
+}
+
+inline int DenseRoutingTable::size() const {
+    return knownDestinations;
+}
+
+// Calls function(destination, entry) for every known destination, in order of destination
+template<typename Function>
+void DenseRoutingTable::forEach(Function function) const {
+    for (int destination = 0; destination < static_cast<int>(nextHops.size()); ++destination) {
+        if (nextHops[destination] != RouteEntry::NO_NEXT_HOP) {
+            function(destination, RouteEntry{nextHops[destination], hopCounts[destination],
+                                             sequenceNumbers[destination]});
+        }
+    }
+}
+
+inline size_t SparseRoutingTable::find(int destination) const {
+    return std::lower_bound(destinations.begin(), destinations.end(), destination) - destinations.begin();
+}
+
+inline bool SparseRoutingTable::contains(int destination) const {
+    size_t index = find(destination);
+    return index < destinations.size() && destinations[index] == destination;
+}
+
+inline RouteEntry SparseRoutingTable::get(int destination) const {
+    RouteEntry entry;
+    size_t index = find(destination);
+    if (index < destinations.size() && destinations[index] == destination) {
+        entry.nextHop = nextHops[index];
+        entry.hops = hopCounts[index];
+        entry.sequenceNumber = sequenceNumbers[index];
+    }
+    return entry;
+}
+
+inline int SparseRoutingTable::size() const {
+    return static_cast<int>(destinations.size());
+}
+
+// Calls function(destination, entry) for every known destination, in order of destination
+template<typename Function>
+void SparseRoutingTable::forEach(Function function) const {
+    for (size_t index = 0; index < destinations.size(); ++index) {
+        function(destinations[index], RouteEntry{nextHops[index], hopCounts[index], sequenceNumbers[index]});
+    }
+}
+
+#endif // ROUTINGTABLE_H
@@ -0,0 +1,126 @@
+#include "EventQueue.h"
+#include <algorithm>
+#include <limits>
+
+// Returns the simulated time that corresponds to the wall clock, or the time of the last event without pacing. The
+// mutex must be held.
+double EventQueue::pacedTime() const {
+    if (pacing <= 0) {
+        return clock;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - pacedFromWallClock).count();
+    return std::max(clock, pacedFrom + elapsed * pacing);
+}
+
+/**
+ * Schedules an action at a simulated time. Times before the current time are moved to the current time, since the
+ * clock never runs backwards.
+ *
+ * @param time The simulated time of the event, in seconds.
+ * @param action The action to run.
+ */
+void EventQueue::schedule(double time, std::function<void()> action) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push(Event{std::max(time, clock), scheduledEvents++, std::move(action)});
+    }
+    changed.notify_all();
+}
+
+// Schedules an action a number of simulated seconds after the current time.
+void EventQueue::scheduleAfter(double delay, std::function<void()> action) {
+    schedule(now() + delay, std::move(action));
+}
+
+// Schedules an action as soon as possible. With pacing, that is the simulated time of the wall clock now, so actions
+// from the user happen between the events that are due and the ones that are not.
+void EventQueue::post(std::function<void()> action) {
+    schedule(now(), std::move(action));
+}
+
+double EventQueue::now() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pacedTime();
+}
+
+/**
+ * Sets how fast the simulated time runs compared to the wall clock. The paced time continues from the current time.
+ *
+ * @param simulatedSecondsPerSecond The simulated seconds per real second, or 0 to run as fast as possible.
+ */
+void EventQueue::setPacing(double simulatedSecondsPerSecond) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pacedFrom = pacedTime();
+        pacedFromWallClock = std::chrono::steady_clock::now();
+        pacing = std::max(simulatedSecondsPerSecond, 0.0);
+    }
+    changed.notify_all();
+}
+
+// Runs the next number of simulated seconds as fast as possible, and then continues with the pacing from there.
+void EventQueue::fastForward(double seconds) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        fastForwardUntil = std::max(fastForwardUntil, pacedTime() + seconds);
+    }
+    changed.notify_all();
+}
+
+/**
+ * Runs the events up to a simulated time, in order. Without pacing the clock jumps from one event to the next. With
+ * pacing, the queue waits until the wall clock reaches the time of the next event, but wakes up when an earlier event
+ * is scheduled, and does not wait for events that are being fast-forwarded. The actions run without the lock, so they
+ * can schedule new events.
+ *
+ * @param endTime The simulated time to run to, which can be infinity to run until stop is called.
+ * @return The number of events that ran.
+ */
+int EventQueue::runUntil(double endTime) {
+    int processed = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopped) {
+        double next = events.empty() ? endTime : std::min(events.top().time, endTime);
+        if (pacing > 0 && next > fastForwardUntil) {
+            if (next == std::numeric_limits<double>::infinity()) {
+                changed.wait(lock);
+                continue;
+            }
+            double wait = (next - pacedFrom) / pacing;
+            auto due = pacedFromWallClock + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(wait));
+            if (std::chrono::steady_clock::now() < due) {
+                changed.wait_until(lock, due);
+                continue;
+            }
+        }
+        if (events.empty() || events.top().time > endTime) {
+            if (endTime != std::numeric_limits<double>::infinity()) {
+                clock = std::max(clock, endTime);
+            }
+            break;
+        }
+        Event event = events.top();
+        events.pop();
+        clock = event.time;
+        if (pacing > 0 && clock <= fastForwardUntil) {
+            // Continue the paced time from here after the fast-forward
+            pacedFrom = clock;
+            pacedFromWallClock = std::chrono::steady_clock::now();
+        }
+        lock.unlock();
+        event.action();
+        processed++;
+        lock.lock();
+    }
+    return processed;
+}
+
+// Makes runUntil return after the event that is running, also when it is called from an action.
+void EventQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    changed.notify_all();
+}
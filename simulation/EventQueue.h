@@ -0,0 +1,63 @@
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+// The core of a discrete-event simulation. Events are actions scheduled at a time on a virtual clock, in seconds, and
+// they run in order of their time, and in the order they were scheduled when the times are equal. The clock jumps from
+// one event to the next, so simulated time runs as fast as the events can be processed. With pacing, the events wait
+// for the wall clock instead, so the simulation runs a chosen number of simulated seconds per real second, and a part
+// of the simulated time can be fast-forwarded. Events can be scheduled from other threads while the queue runs.
+class EventQueue {
+private:
+    struct Event {
+        double time;
+        unsigned long long order;
+        std::function<void()> action;
+    };
+    // Orders the queue so the earliest event is on top
+    struct Later {
+        bool operator()(const Event& a, const Event& b) const {
+            return a.time > b.time || (a.time == b.time && a.order > b.order);
+        }
+    };
+
+    std::priority_queue<Event, std::vector<Event>, Later> events;
+    double clock = 0;
+    unsigned long long scheduledEvents = 0;
+    // Simulated seconds per real second, or 0 to run as fast as possible
+    double pacing = 0;
+    // The simulated time and wall clock time that the paced time is counted from
+    double pacedFrom = 0;
+    std::chrono::steady_clock::time_point pacedFromWallClock;
+    double fastForwardUntil = 0;
+    bool stopped = false;
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+
+    double pacedTime() const;
+
+public:
+    void schedule(double time, std::function<void()> action);
+
+    void scheduleAfter(double delay, std::function<void()> action);
+
+    void post(std::function<void()> action);
+
+    double now() const;
+
+    void setPacing(double simulatedSecondsPerSecond);
+
+    void fastForward(double seconds);
+
+    int runUntil(double endTime);
+
+    void stop();
+};
+
+#endif // EVENTQUEUE_H
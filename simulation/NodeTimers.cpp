@@ -0,0 +1,205 @@
+#include "NodeTimers.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Triggered updates start on, with the default minimum interval and jitter.
+ *
+ * @param tickSeconds The simulated seconds per tick of the timer wheel. The timers fire at whole ticks.
+ * @param seed The seed of the random times of the first broadcasts and of the jitter.
+ */
+NodeTimers::NodeTimers(double tickSeconds, unsigned seed)
+        : tickSeconds(std::max(tickSeconds, 0.001)), random(seed) {
+    setTriggeredUpdates(true, DEFAULT_MIN_TRIGGERED_INTERVAL, DEFAULT_TRIGGER_JITTER);
+}
+
+// Converts a time in seconds to a number of ticks, at least 1, so a periodic timer never fires twice in one tick.
+uint64_t NodeTimers::toTicks(double seconds) const {
+    return std::max<uint64_t>(1, static_cast<uint64_t>(std::llround(seconds / tickSeconds)));
+}
+
+/**
+ * Stops every timer and starts counting the ticks again from a simulated time. The nodes are added again at the next
+ * advance, with new random times for their first broadcasts.
+ *
+ * @param time The simulated time of the first tick, in seconds.
+ */
+void NodeTimers::reset(double time) {
+    wheel = TimerWheel();
+    startTime = time;
+    nodes.clear();
+    expiryTimers.clear();
+    triggeredTimers.clear();
+    nextTriggerTicks.clear();
+    broadcasts = 0;
+    triggeredBroadcasts = 0;
+    expiredRoutes = 0;
+}
+
+/**
+ * Turns the triggered updates on or off. The settings apply to the next triggered update, and an update that is
+ * already waiting is still sent.
+ *
+ * @param enabled Whether nodes send the changed routes when routes appear or break.
+ * @param minInterval The shortest time between two updates of a node, regular or triggered, in seconds.
+ * @param jitter The longest random delay before a triggered update, in seconds.
+ */
+void NodeTimers::setTriggeredUpdates(bool enabled, double minInterval, double jitter) {
+    triggeredUpdates = enabled;
+    minTriggeredInterval = static_cast<uint64_t>(std::llround(std::max(minInterval, 0.0) / tickSeconds));
+    triggerJitter = static_cast<uint64_t>(std::llround(std::max(jitter, 0.0) / tickSeconds));
+}
+
+// Starts the broadcast timer of a new node at a random time within its first broadcast interval.
+void NodeTimers::addNode(Node* node) {
+    nodes.push_back(node);
+    triggeredTimers.push_back(TimerWheel::NO_TIMER);
+    nextTriggerTicks.push_back(0);
+    uint64_t interval = toTicks(node->getBroadcastInterval());
+    scheduleBroadcast(node, std::uniform_int_distribution<uint64_t>(0, interval - 1)(random));
+}
+
+void NodeTimers::scheduleBroadcast(Node* node, uint64_t delay) {
+    wheel.start(delay, [this, node] {
+        broadcast(node);
+    });
+}
+
+/**
+ * Broadcasts the routing table of a node, and starts the timer of the next broadcast. The interval is read from the
+ * node every time, so a new interval applies from the next broadcast on. A triggered update that is waiting is
+ * cancelled, since the broadcast carries the same changes.
+ *
+ * @param node Pointer to the node.
+ */
+void NodeTimers::broadcast(Node* node) {
+    int id = node->getId();
+    wheel.cancel(triggeredTimers[id]);
+    triggeredTimers[id] = TimerWheel::NO_TIMER;
+    node->broadcast();
+    broadcasts++;
+    nextTriggerTicks[id] = wheel.getCurrentTick() + minTriggeredInterval;
+    deliver(node);
+    scheduleBroadcast(node, toTicks(node->getBroadcastInterval()));
+}
+
+// Sends the routes of a node that changed since its last broadcast, when its triggered update timer fires.
+void NodeTimers::sendTriggeredUpdate(Node* node) {
+    int id = node->getId();
+    triggeredTimers[id] = TimerWheel::NO_TIMER;
+    node->broadcastChanges();
+    broadcasts++;
+    triggeredBroadcasts++;
+    nextTriggerTicks[id] = wheel.getCurrentTick() + minTriggeredInterval;
+    deliver(node);
+}
+
+/**
+ * Handles what the nodes that received a broadcast of a sender do next: their expiry timers for the sender start
+ * again, and the receivers whose routes appeared or broke start a triggered update.
+ *
+ * @param sender Pointer to the node that broadcast.
+ */
+void NodeTimers::deliver(Node* sender) {
+    for (Node* receiver : sender->getNodesInRadius()) {
+        if (receiver != sender) {
+            restartExpiry(receiver, sender);
+            triggerUpdate(receiver);
+        }
+    }
+}
+
+/**
+ * Starts a triggered update of a node whose routes appeared or broke, unless triggered updates are off or one is
+ * already waiting. The update is sent after a random jitter, and not before the minimum interval since the last update
+ * of the node has passed.
+ *
+ * @param node Pointer to the node.
+ */
+void NodeTimers::triggerUpdate(Node* node) {
+    int id = node->getId();
+    if (!triggeredUpdates || node->getSignificantChanges() == 0 || triggeredTimers[id] != TimerWheel::NO_TIMER) {
+        return;
+    }
+    uint64_t now = wheel.getCurrentTick();
+    uint64_t delay = nextTriggerTicks[id] > now ? nextTriggerTicks[id] - now : 0;
+    delay += std::uniform_int_distribution<uint64_t>(0, triggerJitter)(random);
+    triggeredTimers[id] = wheel.start(delay, [this, node] {
+        sendTriggeredUpdate(node);
+    });
+}
+
+/**
+ * Cancels the expiry timer of the routes a receiver has through a sender, and starts it again with EXPIRY_INTERVALS
+ * broadcast intervals of the sender. When it fires, the routes are marked as broken.
+ *
+ * @param receiver Pointer to the node that heard the sender.
+ * @param sender Pointer to the node that broadcast.
+ */
+void NodeTimers::restartExpiry(Node* receiver, Node* sender) {
+    uint64_t key = (static_cast<uint64_t>(receiver->getId()) << 32) | static_cast<uint32_t>(sender->getId());
+    auto timer = expiryTimers.find(key);
+    if (timer != expiryTimers.end()) {
+        wheel.cancel(timer->second);
+    }
+    expiryTimers[key] = wheel.start(toTicks(EXPIRY_INTERVALS * sender->getBroadcastInterval()),
+                                    [this, key, receiver, sender] {
+        expiredRoutes += receiver->expireRoutesThrough(sender->getId());
+        expiryTimers.erase(key);
+        triggerUpdate(receiver);
+    });
+}
+
+/**
+ * Adds the nodes that are new since the last advance, and runs every timer that is due up to a simulated time, in
+ * order.
+ *
+ * @param allNodes Vector of pointers to all nodes, indexed by node id.
+ * @param time The simulated time to advance to, in seconds.
+ * @return The number of timers that fired.
+ */
+int NodeTimers::advanceTo(const std::vector<Node*>& allNodes, double time) {
+    for (size_t node = nodes.size(); node < allNodes.size(); ++node) {
+        addNode(allNodes[node]);
+    }
+    if (time < startTime) {
+        return 0;
+    }
+    uint64_t lastTick = static_cast<uint64_t>(std::floor((time - startTime) / tickSeconds + 1e-9));
+    if (lastTick < wheel.getCurrentTick()) {
+        return 0;
+    }
+    return wheel.advance(lastTick - wheel.getCurrentTick() + 1);
+}
+
+bool NodeTimers::getTriggeredUpdates() const {
+    return triggeredUpdates;
+}
+
+double NodeTimers::getMinTriggeredInterval() const {
+    return static_cast<double>(minTriggeredInterval) * tickSeconds;
+}
+
+double NodeTimers::getTriggerJitter() const {
+    return static_cast<double>(triggerJitter) * tickSeconds;
+}
+
+// Returns the number of broadcasts since the last reset, regular and triggered.
+int NodeTimers::getBroadcasts() const {
+    return broadcasts;
+}
+
+// Returns the number of triggered updates since the last reset.
+int NodeTimers::getTriggeredBroadcasts() const {
+    return triggeredBroadcasts;
+}
+
+// Returns the number of routes that were marked as broken since the last reset.
+int NodeTimers::getExpiredRoutes() const {
+    return expiredRoutes;
+}
+
+// Returns the number of broadcast and expiry timers that are running.
+int NodeTimers::getActiveTimers() const {
+    return wheel.getActiveTimers();
+}
@@ -0,0 +1,89 @@
+#ifndef NODETIMERS_H
+#define NODETIMERS_H
+
+#include "TimerWheel.h"
+#include "../node/Node.h"
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// Runs the periodic work of every node on a timer wheel instead of in rounds. Every node broadcasts on its own timer,
+// once per broadcast interval of the node, starting at a random time within the first interval. Every pair of a
+// receiver and a sender has an expiry timer, which is started again each time the receiver hears the sender. When
+// nothing was heard from the sender for EXPIRY_INTERVALS of its broadcast intervals, the timer fires and the routes of
+// the receiver through the sender are marked as broken. With thousands of nodes there are thousands of broadcast
+// timers and many more expiry timers, and almost every broadcast restarts some of them, so the wheel makes starting and
+// cancelling a timer O(1).
+//
+// With triggered updates, a node whose routes appeared or broke does not wait for its next regular broadcast, but sends
+// the changed routes after a short random jitter. A node never sends updates closer together than the minimum interval,
+// and the changes it learns in the meantime wait for the next update, so one topology change spreads through the mesh
+// as one wave of updates instead of a storm, and the jitter keeps neighbors that heard the same update from sending at
+// the same moment.
+class NodeTimers {
+private:
+    TimerWheel wheel;
+    double tickSeconds;
+    // The simulated time of tick 0 of the wheel
+    double startTime = 0;
+    std::mt19937 random;
+    std::vector<Node*> nodes;
+    // The expiry timers, by receiver id in the high and sender id in the low 32 bits
+    std::unordered_map<uint64_t, TimerWheel::TimerId> expiryTimers;
+    bool triggeredUpdates = false;
+    uint64_t minTriggeredInterval = 0;
+    uint64_t triggerJitter = 0;
+    // The pending triggered update of every node, and the first tick its next triggered update may be sent, by node id
+    std::vector<TimerWheel::TimerId> triggeredTimers;
+    std::vector<uint64_t> nextTriggerTicks;
+    int broadcasts = 0;
+    int triggeredBroadcasts = 0;
+    int expiredRoutes = 0;
+
+    uint64_t toTicks(double seconds) const;
+
+    void addNode(Node* node);
+
+    void scheduleBroadcast(Node* node, uint64_t delay);
+
+    void broadcast(Node* node);
+
+    void sendTriggeredUpdate(Node* node);
+
+    void deliver(Node* sender);
+
+    void triggerUpdate(Node* node);
+
+    void restartExpiry(Node* receiver, Node* sender);
+
+public:
+    static constexpr double DEFAULT_TICK_SECONDS = 0.1;
+    static const int EXPIRY_INTERVALS = 3;
+    static constexpr double DEFAULT_MIN_TRIGGERED_INTERVAL = 1.0;
+    static constexpr double DEFAULT_TRIGGER_JITTER = 0.5;
+
+    NodeTimers(double tickSeconds, unsigned seed);
+
+    void reset(double time);
+
+    int advanceTo(const std::vector<Node*>& allNodes, double time);
+
+    void setTriggeredUpdates(bool enabled, double minInterval, double jitter);
+
+    bool getTriggeredUpdates() const;
+
+    double getMinTriggeredInterval() const;
+
+    double getTriggerJitter() const;
+
+    int getBroadcasts() const;
+
+    int getTriggeredBroadcasts() const;
+
+    int getExpiredRoutes() const;
+
+    int getActiveTimers() const;
+};
+
+#endif // NODETIMERS_H
@@ -0,0 +1,146 @@
+#include "TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel() : slots(WHEELS * SLOTS, NO_INDEX) {}
+
+/**
+ * Puts a timer into the slot of its expiry tick, in the lowest wheel that reaches that far from the current tick.
+ * Timers that are already due go into the slot of the current tick. A timer beyond the reach of the last wheel is
+ * parked in the last slot the wheel reaches, and keeps its expiry tick, so when that slot is cascaded it is linked
+ * again by the delay that is left.
+ *
+ * @param index The index of the timer.
+ */
+void TimerWheel::link(int index) {
+    Timer& timer = timers[index];
+    uint64_t expires = std::max(timer.expires, currentTick);
+    uint64_t delay = expires - currentTick;
+    int wheel = 0;
+    while (wheel < WHEELS - 1 && delay >= (uint64_t{1} << (SLOT_BITS * (wheel + 1)))) {
+        wheel++;
+    }
+    if (delay >= (uint64_t{1} << (SLOT_BITS * WHEELS))) {
+        expires = currentTick + (uint64_t{1} << (SLOT_BITS * WHEELS)) - 1;
+    }
+    int slot = wheel * SLOTS + static_cast<int>((expires >> (SLOT_BITS * wheel)) & (SLOTS - 1));
+    timer.slot = slot;
+    timer.previous = NO_INDEX;
+    timer.next = slots[slot];
+    if (slots[slot] != NO_INDEX) {
+        timers[slots[slot]].previous = index;
+    }
+    slots[slot] = index;
+}
+
+// Takes a timer out of its slot.
+void TimerWheel::unlink(int index) {
+    Timer& timer = timers[index];
+    if (timer.previous != NO_INDEX) {
+        timers[timer.previous].next = timer.next;
+    } else {
+        slots[timer.slot] = timer.next;
+    }
+    if (timer.next != NO_INDEX) {
+        timers[timer.next].previous = timer.previous;
+    }
+    timer.slot = NO_INDEX;
+}
+
+// Moves the timers in the current slot of a wheel down to the lower wheels.
+void TimerWheel::cascade(int wheel) {
+    int slot = wheel * SLOTS + static_cast<int>((currentTick >> (SLOT_BITS * wheel)) & (SLOTS - 1));
+    int index = slots[slot];
+    slots[slot] = NO_INDEX;
+    while (index != NO_INDEX) {
+        int next = timers[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+/**
+ * Starts a timer.
+ *
+ * @param delay The number of ticks until the timer fires. A delay of 0 fires at the next processed tick, or in the
+ *              current tick when the timer is started by the action of another timer.
+ * @param action The action to run when the timer fires.
+ * @return The id of the timer, for cancelling it.
+ */
+TimerWheel::TimerId TimerWheel::start(uint64_t delay, std::function<void()> action) {
+    int index;
+    if (!freeTimers.empty()) {
+        index = freeTimers.back();
+        freeTimers.pop_back();
+    } else {
+        index = static_cast<int>(timers.size());
+        timers.emplace_back();
+    }
+    Timer& timer = timers[index];
+    timer.expires = currentTick + delay;
+    timer.action = std::move(action);
+    link(index);
+    activeTimers++;
+    return (static_cast<uint64_t>(timer.generation) << 32) | static_cast<uint32_t>(index);
+}
+
+/**
+ * Cancels a timer that has not fired yet.
+ *
+ * @param id The id of the timer.
+ * @return Whether the timer was running.
+ */
+bool TimerWheel::cancel(TimerId id) {
+    int index = static_cast<int>(id & 0xFFFFFFFF);
+    if (index < 0 || index >= static_cast<int>(timers.size())) {
+        return false;
+    }
+    Timer& timer = timers[index];
+    if (timer.generation != (id >> 32) || timer.slot == NO_INDEX) {
+        return false;
+    }
+    unlink(index);
+    timer.action = nullptr;
+    timer.generation++;
+    freeTimers.push_back(index);
+    activeTimers--;
+    return true;
+}
+
+/**
+ * Processes a number of ticks, and runs the actions of the timers that are due, in order of their ticks. The actions
+ * may start and cancel timers.
+ *
+ * @param ticks The number of ticks to process.
+ * @return The number of timers that fired.
+ */
+int TimerWheel::advance(uint64_t ticks) {
+    int fired = 0;
+    for (uint64_t tick = 0; tick < ticks; ++tick) {
+        for (int wheel = 1; wheel < WHEELS && (currentTick & ((uint64_t{1} << (SLOT_BITS * wheel)) - 1)) == 0;
+             ++wheel) {
+            cascade(wheel);
+        }
+        int slot = static_cast<int>(currentTick & (SLOTS - 1));
+        while (slots[slot] != NO_INDEX) {
+            int index = slots[slot];
+            unlink(index);
+            std::function<void()> action = std::move(timers[index].action);
+            timers[index].action = nullptr;
+            timers[index].generation++;
+            freeTimers.push_back(index);
+            activeTimers--;
+            action();
+            fired++;
+        }
+        currentTick++;
+    }
+    return fired;
+}
+
+uint64_t TimerWheel::getCurrentTick() const {
+    return currentTick;
+}
+
+int TimerWheel::getActiveTimers() const {
+    return activeTimers;
+}
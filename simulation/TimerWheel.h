@@ -0,0 +1,65 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// A hierarchical timing wheel. Time is counted in ticks, and a timer is stored in a slot of one of four wheels of 64
+// slots: the first wheel has a slot for each of the next 64 ticks, the second a slot for each of the next 64 blocks of
+// 64 ticks, and so on. When the first wheel has turned around, the timers in the next slot of the second wheel are
+// spread over the first wheel, and likewise for the higher wheels. Starting and cancelling a timer are O(1), since the
+// slots are doubly linked lists of timers kept in one array, and a tick only touches the timers that are due or moved
+// down a wheel. Timers further away than the four wheels reach, 2^24 ticks, are parked at the end of the last wheel
+// until they come within its reach.
+class TimerWheel {
+public:
+    // Identifies a started timer. An id stays invalid after its timer has fired or been cancelled.
+    using TimerId = uint64_t;
+    static constexpr TimerId NO_TIMER = 0;
+
+private:
+    static constexpr int WHEELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr int NO_INDEX = -1;
+
+    struct Timer {
+        uint64_t expires = 0;
+        std::function<void()> action;
+        int previous = NO_INDEX;
+        int next = NO_INDEX;
+        int slot = NO_INDEX;
+        // Increased every time the entry is reused, so old ids do not match
+        uint32_t generation = 1;
+    };
+
+    std::vector<Timer> timers;
+    std::vector<int> freeTimers;
+    // The first timer of every slot, with the slots of all wheels one after the other
+    std::vector<int> slots;
+    // The next tick to process
+    uint64_t currentTick = 0;
+    int activeTimers = 0;
+
+    void link(int index);
+
+    void unlink(int index);
+
+    void cascade(int wheel);
+
+public:
+    TimerWheel();
+
+    TimerId start(uint64_t delay, std::function<void()> action);
+
+    bool cancel(TimerId id);
+
+    int advance(uint64_t ticks);
+
+    uint64_t getCurrentTick() const;
+
+    int getActiveTimers() const;
+};
+
+#endif // TIMERWHEEL_H
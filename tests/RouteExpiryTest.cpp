@@ -0,0 +1,96 @@
+#include "../node/Node.h"
+#include "../topography/Topography.h"
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+int failures = 0;
+
+void check(bool condition, const string& description) {
+    if (!condition) {
+        cout << "FAILED: " << description << endl;
+        failures++;
+    }
+}
+
+// Merges a broken route to the owner of a table into the table with every merge of both tables, and checks that the
+// own route is kept and its sequence number moves to the next even number above the broken one.
+template<typename Table>
+void checkOwnRouteIsKept(const string& name, bool updates, bool vectorized) {
+    const int ownId = 17;
+    const int neighborId = 3;
+    Table own, received;
+    for (int destination = 0; destination < 40; ++destination) {
+        own.set(destination, RouteEntry{destination == ownId ? ownId : neighborId,
+                                        static_cast<uint16_t>(destination == ownId ? 0 : 2), 10});
+        received.set(destination, RouteEntry{neighborId, 1, 12});
+    }
+    received.set(ownId, RouteEntry{neighborId, RouteEntry::INFINITE_HOPS, 11});
+
+    if (updates) {
+        vector<RouteUpdate> routes;
+        received.forEach([&routes](int destination, const RouteEntry& entry) {
+            routes.push_back(RouteUpdate{destination, entry});
+        });
+        own.merge(routes, neighborId, ownId);
+    } else if constexpr (std::is_same_v<Table, DenseRoutingTable>) {
+        own.merge(received, neighborId, ownId, nullptr, vectorized);
+    } else {
+        own.merge(received, neighborId, ownId);
+    }
+
+    RouteEntry entry = own.get(ownId);
+    check(entry.nextHop == ownId && entry.hops == 0, name + ": the own route is kept");
+    check(entry.sequenceNumber == 12, name + ": the own sequence number moves past the broken one");
+    check(own.get(ownId + 1).sequenceNumber == 12, name + ": the other routes are merged");
+}
+
+// A node that was silent long enough for its neighbor to expire it gets the broken route to itself back from the
+// neighbor, and must be reachable again after its next broadcast.
+void checkExpiredNodeRecovers() {
+    Topography topography;
+    vector<Node*> nodes = {new Node(0, 100, 100, 10, 5000, &topography), new Node(1, 110, 100, 10, 5000, &topography)};
+    for (Node* node : nodes) {
+        node->updateAllNodes(nodes);
+        node->setFullDumpInterval(1);
+    }
+    Node& silent = *nodes[0];
+    Node& neighbor = *nodes[1];
+    silent.broadcast();
+    neighbor.broadcast();
+    check(neighbor.getRoutingTable().get(0).hops == 1, "the neighbor learns the route to the node");
+
+    check(neighbor.expireRoutesThrough(0) > 0, "the neighbor expires the route to the silent node");
+    RouteEntry broken = neighbor.getRoutingTable().get(0);
+    check(broken.hops == RouteEntry::INFINITE_HOPS && broken.sequenceNumber % 2 == 1, "the expired route is broken");
+
+    neighbor.broadcast();
+    RouteEntry own = silent.getRoutingTable().get(0);
+    check(own.nextHop == 0 && own.hops == 0, "the node keeps its own route when it receives the broken one");
+    check(own.sequenceNumber > broken.sequenceNumber && own.sequenceNumber % 2 == 0,
+          "the own sequence number moves to an even number above the broken one");
+
+    silent.broadcast();
+    RouteEntry repaired = neighbor.getRoutingTable().get(0);
+    check(repaired.nextHop == 0 && repaired.hops == 1, "the node is reachable again after its next broadcast");
+    check(silent.getRoutingTable().get(0).hops == 0, "the node still advertises itself with 0 hops");
+    for (Node* node : nodes) {
+        delete node;
+    }
+}
+
+int main() {
+    checkOwnRouteIsKept<DenseRoutingTable>("dense scalar merge", false, false);
+    checkOwnRouteIsKept<DenseRoutingTable>("dense SIMD merge", false, true);
+    checkOwnRouteIsKept<DenseRoutingTable>("dense update merge", true, false);
+    checkOwnRouteIsKept<SparseRoutingTable>("sparse merge", false, false);
+    checkOwnRouteIsKept<SparseRoutingTable>("sparse update merge", true, false);
+    checkExpiredNodeRecovers();
+    if (failures == 0) {
+        cout << "All route expiry checks passed" << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
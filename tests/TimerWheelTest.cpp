@@ -0,0 +1,125 @@
+#include "../simulation/TimerWheel.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int failures = 0;
+
+void check(bool condition, const string& description) {
+    if (!condition) {
+        cout << "FAILED: " << description << endl;
+        failures++;
+    }
+}
+
+// A timer of the test, with the tick it has to fire at and the ticks it fired at
+struct TestTimer {
+    TimerWheel::TimerId id = TimerWheel::NO_TIMER;
+    uint64_t expires = 0;
+    bool cancelled = false;
+    vector<uint64_t> firedAt;
+};
+
+// Starts a timer that records the ticks it fires at.
+void startTimer(TimerWheel& wheel, vector<TestTimer>& testTimers, uint64_t delay) {
+    size_t index = testTimers.size();
+    testTimers.emplace_back();
+    testTimers[index].expires = wheel.getCurrentTick() + delay;
+    testTimers[index].id = wheel.start(delay, [&wheel, &testTimers, index] {
+        testTimers[index].firedAt.push_back(wheel.getCurrentTick());
+    });
+}
+
+// Returns a random delay that puts a timer into the given wheel, or beyond the last wheel for wheel 4, where it is
+// parked until it comes within reach.
+uint64_t randomDelay(mt19937_64& random, int wheel) {
+    uint64_t lowest = wheel == 0 ? 0 : uint64_t{1} << (6 * wheel);
+    uint64_t highest = wheel < 4 ? (uint64_t{1} << (6 * (wheel + 1))) - 1 : (uint64_t{1} << 24) + (uint64_t{1} << 22);
+    return uniform_int_distribution<uint64_t>(lowest, highest)(random);
+}
+
+// Starts timers at random delays in all four wheels and beyond them, at different ticks of the wheels, cancels some of
+// them, and checks that every other timer fires exactly once at its expiry tick.
+void checkTimersFireAtTheirTick() {
+    mt19937_64 random(2024);
+    TimerWheel wheel;
+    vector<TestTimer> testTimers;
+    testTimers.reserve(4000);
+    for (int batch = 0; batch < 4; ++batch) {
+        for (int timer = 0; timer < 500; ++timer) {
+            startTimer(wheel, testTimers, randomDelay(random, timer % 5));
+        }
+        // The next batch starts at a tick that is not aligned to the slots of the wheels
+        wheel.advance(uniform_int_distribution<uint64_t>(1, 5000)(random));
+    }
+
+    for (size_t index = 0; index < testTimers.size(); index += 4) {
+        if (testTimers[index].firedAt.empty()) {
+            check(wheel.cancel(testTimers[index].id), "a running timer can be cancelled");
+            check(!wheel.cancel(testTimers[index].id), "a cancelled timer cannot be cancelled again");
+            testTimers[index].cancelled = true;
+        } else {
+            check(!wheel.cancel(testTimers[index].id), "a timer that fired cannot be cancelled");
+        }
+    }
+    // The entries of the cancelled timers are reused, and the old ids must not cancel the new timers
+    size_t firstReused = testTimers.size();
+    for (int timer = 0; timer < 500; ++timer) {
+        startTimer(wheel, testTimers, randomDelay(random, timer % 5));
+    }
+    for (size_t index = 0; index < firstReused; index += 4) {
+        if (testTimers[index].cancelled) {
+            check(!wheel.cancel(testTimers[index].id), "the id of a cancelled timer does not cancel a new timer");
+        }
+    }
+
+    uint64_t lastExpiry = 0;
+    for (const TestTimer& testTimer : testTimers) {
+        lastExpiry = max(lastExpiry, testTimer.expires);
+    }
+    while (wheel.getCurrentTick() <= lastExpiry) {
+        wheel.advance(uniform_int_distribution<uint64_t>(1, 1 << 20)(random));
+    }
+
+    int wrongTicks = 0;
+    for (const TestTimer& testTimer : testTimers) {
+        if (testTimer.cancelled) {
+            wrongTicks += !testTimer.firedAt.empty();
+        } else {
+            wrongTicks += testTimer.firedAt.size() != 1 || testTimer.firedAt[0] != testTimer.expires;
+        }
+    }
+    check(wrongTicks == 0, to_string(wrongTicks) + " timers did not fire exactly once at their tick, or fired after "
+                           "they were cancelled");
+    check(wheel.getActiveTimers() == 0, "no timer is left after the last expiry");
+}
+
+// A timer that is started by the action of another timer fires at its own tick, also with a delay of 0.
+void checkTimersStartedByActions() {
+    TimerWheel wheel;
+    vector<uint64_t> firedAt;
+    wheel.start(100, [&wheel, &firedAt] {
+        firedAt.push_back(wheel.getCurrentTick());
+        wheel.start(0, [&wheel, &firedAt] {
+            firedAt.push_back(wheel.getCurrentTick());
+        });
+        wheel.start(5000, [&wheel, &firedAt] {
+            firedAt.push_back(wheel.getCurrentTick());
+        });
+    });
+    wheel.advance(6000);
+    check(firedAt == vector<uint64_t>{100, 100, 5100}, "timers started by an action fire at their own tick");
+}
+
+int main() {
+    checkTimersFireAtTheirTick();
+    checkTimersStartedByActions();
+    if (failures == 0) {
+        cout << "All timer wheel checks passed" << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
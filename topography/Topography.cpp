@@ -9,6 +9,10 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <random>
+#include <limits>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 /**
  * Performs bilinear interpolation between four points.
@@ -163,6 +167,18 @@ std::vector<std::vector<int>> Topography::generateMountainElevation(int rows, in
     return data;
 }
 
+/**
+ * Converts the elevation data into a grayscale value for visualization.
+ *
+ * @param elevation The elevation to convert to grayscale.
+ * @param minElevation The minimum elevation in the data set.
+ * @param maxElevation The maximum elevation in the data set.
+ * @return A grayscale value representing the elevation.
+ */
+int getGrayscale(int elevation, int minElevation, int maxElevation) {
+    return 255 - ((elevation - minElevation) * 255) / (maxElevation - minElevation);
+}
+
 /**
  * Returns the current elevation data of the topography.
  *
@@ -179,6 +195,23 @@ std::vector<std::vector<int>> Topography::getElevationData() {
  */
 void Topography::setElevationData(const std::vector<std::vector<int>> &elevationData) {
     Topography::elevationData = elevationData;
+
+    // The elevation range is cached so renders of a viewport do not have to visit the whole map
+    minElevation = elevationData[0][0];
+    maxElevation = elevationData[0][0];
+    for (const auto& row : elevationData) {
+        for (const auto& elevation : row) {
+            minElevation = std::min(minElevation, elevation);
+            maxElevation = std::max(maxElevation, elevation);
+        }
+    }
+
+    // Grayscale of every elevation in the range, so renders do not have to divide for every pixel
+    grayscaleLookup.resize(static_cast<size_t>(maxElevation) - minElevation + 1);
+    for (int elevation = minElevation; elevation <= maxElevation; ++elevation) {
+        grayscaleLookup[elevation - minElevation] =
+                maxElevation == minElevation ? 255 : getGrayscale(elevation, minElevation, maxElevation);
+    }
 }
 
 /**
@@ -422,18 +455,6 @@ bool Topography::isObstructionBetween(int startX, int startY, int startZ,
     return false;
 }
 
-/**
- * Converts the elevation data into a grayscale value for visualization.
- *
- * @param elevation The elevation to convert to grayscale.
- * @param minElevation The minimum elevation in the data set.
- * @param maxElevation The maximum elevation in the data set.
- * @return A grayscale value representing the elevation.
- */
-int getGrayscale(int elevation, int minElevation, int maxElevation) {
-    return 255 - ((elevation - minElevation) * 255) / (maxElevation - minElevation);
-}
-
 /**
  * Generates a line between two nodes using the Bresenham's line algorithm.
  *
@@ -468,24 +489,6 @@ std::vector<std::pair<int, int>> drawLine(Node* nodeA, Node* nodeB) {
     return linePoints;
 }
 
-/**
- * Checks if a given coordinate corresponds to a drone position.
- *
- * @param nodes Vector of pointers to nodes representing drone positions.
- * @param x x-coordinate to check.
- * @param y y-coordinate to check.
- * @return true if the coordinates correspond to a drone position, false otherwise.
- */
-bool isDronePosition(const std::vector<Node*>& nodes, int x, int y) {
-    for (const auto& node : nodes) {
-        int distance = std::sqrt(std::pow(x - node->getX(), 2) + std::pow(y - node->getY(), 2));
-        if (distance == 0) {
-            return true;
-        }
-    }
-    return false;
-}
-
 /**
  * Computes the total signal influence of drones at a given position.
  *
@@ -515,196 +518,863 @@ int Topography::getTotalDroneInfluence(const std::vector<Node*>& nodes, int x, i
 }
 
 /**
- * Writes a pixel to a file based on its grayscale value and the total influence.
- *
- * @param file Reference to an output file stream.
- * @param grayscale The grayscale value of the pixel.
- * @param totalInfluence The total influence at the pixel location.
- */
-void writeInfluencedPixel(std::ofstream& file, int grayscale, int totalInfluence) {
-    file.put(static_cast<int>((grayscale * (100.0 - totalInfluence)) / 100.0));
-    file.put(static_cast<int>((grayscale * (100.0 - totalInfluence) + totalInfluence * 255.0) / 100.0));
-    file.put(static_cast<int>((grayscale * (100.0 - totalInfluence)) / 100.0));
-}
-
-/**
- * Writes a grayscale pixel to a file.
+ * Blends the signal influence into a row of grayscale pixels. For every pixel, the red and blue channels become
+ * grayscale * (100 - influence) / 100, and the green channel becomes (grayscale * (100 - influence) + influence * 255) / 100,
+ * rounded down. With SSE2, eight pixels are blended at a time in 16-bit lanes, where the division by 100 is done as a
+ * multiplication by 5243 followed by a shift of 19, which is exact for every value the blend can produce.
  *
- * @param file Reference to an output file stream.
- * @param grayscale The grayscale value of the pixel.
+ * @param grayscale The grayscale value of each pixel in the row.
+ * @param influence The total influence of each pixel in the row, between 0 and 100.
+ * @param redBlue Receives the red and blue channel of each pixel.
+ * @param green Receives the green channel of each pixel.
+ * @param width The number of pixels in the row.
  */
-void writeGrayscalePixel(std::ofstream& file, int grayscale) {
-    file.put(grayscale);
-    file.put(grayscale);
-    file.put(grayscale);
+void blendInfluenceRow(const uint16_t* grayscale, const uint16_t* influence, uint8_t* redBlue, uint8_t* green, int width) {
+    int x = 0;
+#ifdef __SSE2__
+    const __m128i hundred = _mm_set1_epi16(100);
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i reciprocal = _mm_set1_epi16(5243);
+    for (; x + 8 <= width; x += 8) {
+        __m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(grayscale + x));
+        __m128i total = _mm_loadu_si128(reinterpret_cast<const __m128i*>(influence + x));
+        __m128i dimmed = _mm_mullo_epi16(gray, _mm_sub_epi16(hundred, total));
+        __m128i tinted = _mm_add_epi16(dimmed, _mm_mullo_epi16(total, full));
+        dimmed = _mm_srli_epi16(_mm_mulhi_epu16(dimmed, reciprocal), 3);
+        tinted = _mm_srli_epi16(_mm_mulhi_epu16(tinted, reciprocal), 3);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(redBlue + x), _mm_packus_epi16(dimmed, dimmed));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(green + x), _mm_packus_epi16(tinted, tinted));
+    }
+#endif
+    for (; x < width; ++x) {
+        int dimmed = grayscale[x] * (100 - influence[x]);
+        redBlue[x] = static_cast<uint8_t>(dimmed / 100);
+        green[x] = static_cast<uint8_t>((dimmed + influence[x] * 255) / 100);
+    }
 }
 
 /**
  * Writes the headers for a BMP image file.
  *
- * @param file Reference to an output file stream.
+ * @param file Reference to an output stream.
  * @param width The width of the image.
  * @param height The height of the image.
+ * @param bitsPerPixel The number of bits per pixel, 24 for true color or 8 for palette images.
+ * @param compression The compression method, 0 for uncompressed or 1 for BI_RLE8.
+ * @param paletteSize The number of colors in the palette that follows the headers.
  */
-void writeBMPHeaders(std::ofstream& file, int width, int height) {
+void writeBMPHeaders(std::ostream& file, int width, int height, int bitsPerPixel = 24, int compression = 0,
+                     int paletteSize = 0) {
+    int pixelDataOffset = 54 + paletteSize * 4;
+
     // Bitmap file header (14 bytes)
     file.put('B').put('M');  // Magic number
     file.put(0).put(0).put(0).put(0);  // File size in bytes (will fill later)
     file.put(0).put(0);  // Reserved field
     file.put(0).put(0);  // Reserved field
-    file.put(54).put(0).put(0).put(0);  // Offset of pixel data inside the image
+    file.write(reinterpret_cast<const char*>(&pixelDataOffset), 4);  // Offset of pixel data inside the image
 
     // Bitmap info header (40 bytes)
     file.put(40).put(0).put(0).put(0);  // Info header size
     file.write(reinterpret_cast<const char*>(&width), 4);  // Image width
     file.write(reinterpret_cast<const char*>(&height), 4);  // Image height
     file.put(1).put(0);  // Number of color planes
-    file.put(24).put(0);  // Bits per pixel
-    file.put(0).put(0).put(0).put(0);  // Compression
-    file.put(0).put(0).put(0).put(0);  // Image size
+    file.put(bitsPerPixel).put(0);  // Bits per pixel
+    file.write(reinterpret_cast<const char*>(&compression), 4);  // Compression
+    file.put(0).put(0).put(0).put(0);  // Image size (will fill later)
     file.put(0).put(0).put(0).put(0);  // Horizontal resolution
     file.put(0).put(0).put(0).put(0);  // Vertical resolution
-    file.put(0).put(0).put(0).put(0);  // Number of colors
+    file.write(reinterpret_cast<const char*>(&paletteSize), 4);  // Number of colors
     file.put(0).put(0).put(0).put(0);  // Important colors
 }
 
+// Layout of the fixed palette used by the 8-bit images. The first two entries are the drone and line colors, followed
+// by every combination of the grayscale and influence levels.
+const int PALETTE_DRONE = 0;
+const int PALETTE_LINE = 1;
+const int PALETTE_GRAYSCALE_LEVELS = 32;
+const int PALETTE_INFLUENCE_LEVELS = 7;
+const int PALETTE_SIZE = 2 + PALETTE_GRAYSCALE_LEVELS * PALETTE_INFLUENCE_LEVELS;
+
 /**
- * Writes a topographical map to a BMP image file.
+ * Builds the fixed palette of the 8-bit images, as BGRA quads in the order they are stored in the file.
  *
- * This method visualizes the drone network, including drone positions, signal influences, and drone connections,
- * on a grayscale map. The color of each pixel is determined by the terrain elevation, the signal influence of
- * drones at the pixel's position, and whether a drone is present or a drone connection passes through the pixel's position.
+ * @return The palette entries.
+ */
+std::vector<uint8_t> buildIndexedPalette() {
+    std::vector<uint8_t> palette(PALETTE_SIZE * 4, 0);
+    auto setEntry = [&](int index, int blue, int green, int red) {
+        palette[index * 4] = blue;
+        palette[index * 4 + 1] = green;
+        palette[index * 4 + 2] = red;
+    };
+    setEntry(PALETTE_DRONE, 0, 0, 255);
+    setEntry(PALETTE_LINE, 255, 0, 0);
+    for (int influenceLevel = 0; influenceLevel < PALETTE_INFLUENCE_LEVELS; ++influenceLevel) {
+        int influence = influenceLevel * 70 / (PALETTE_INFLUENCE_LEVELS - 1);
+        for (int grayscaleLevel = 0; grayscaleLevel < PALETTE_GRAYSCALE_LEVELS; ++grayscaleLevel) {
+            int grayscale = grayscaleLevel * 255 / (PALETTE_GRAYSCALE_LEVELS - 1);
+            int dimmed = grayscale * (100 - influence) / 100;
+            int tinted = (grayscale * (100 - influence) + influence * 255) / 100;
+            setEntry(2 + influenceLevel * PALETTE_GRAYSCALE_LEVELS + grayscaleLevel, dimmed, tinted, dimmed);
+        }
+    }
+    return palette;
+}
+
+/**
+ * Compresses one row of palette indices with BI_RLE8. Repeated indices are written as runs, and stretches without
+ * repetition are written in absolute mode. The row is terminated with an end of line marker.
+ *
+ * @param row The palette indices of the row.
+ * @param width The number of pixels in the row.
+ * @param out Receives the compressed row.
+ */
+void encodeRLE8Row(const uint8_t* row, int width, std::vector<uint8_t>& out) {
+    int x = 0;
+    while (x < width) {
+        int run = 1;
+        while (x + run < width && run < 255 && row[x + run] == row[x]) {
+            run++;
+        }
+        if (run >= 2) {
+            out.push_back(run);
+            out.push_back(row[x]);
+            x += run;
+            continue;
+        }
+
+        // Collect pixels until the next repetition starts
+        int end = x;
+        while (end < width && end - x < 255 && !(end + 1 < width && row[end] == row[end + 1])) {
+            end++;
+        }
+        int count = end - x;
+        if (count < 3) {
+            // Absolute mode needs at least 3 pixels
+            for (int i = x; i < end; ++i) {
+                out.push_back(1);
+                out.push_back(row[i]);
+            }
+        } else {
+            out.push_back(0);
+            out.push_back(count);
+            out.insert(out.end(), row + x, row + end);
+            if (count % 2 == 1) {
+                out.push_back(0);  // Absolute runs are padded to 16 bits
+            }
+        }
+        x = end;
+    }
+    out.push_back(0);
+    out.push_back(0);  // End of line
+}
+
+/**
+ * Clamps a viewport to the map. A width or height of 0 extends the viewport to the edge of the map, and the zoom is
+ * at least 1.
+ *
+ * @param viewport The requested viewport.
+ * @return A viewport that lies inside the map.
+ */
+Viewport Topography::clampViewport(const Viewport& viewport) const {
+    int mapWidth = elevationData[0].size();
+    int mapHeight = elevationData.size();
+
+    Viewport clamped;
+    clamped.x = std::clamp(viewport.x, 0, mapWidth - 1);
+    clamped.y = std::clamp(viewport.y, 0, mapHeight - 1);
+    clamped.width = viewport.width > 0 ? std::min(viewport.width, mapWidth - clamped.x) : mapWidth - clamped.x;
+    clamped.height = viewport.height > 0 ? std::min(viewport.height, mapHeight - clamped.y) : mapHeight - clamped.y;
+    clamped.zoom = std::max(viewport.zoom, 1);
+    return clamped;
+}
+
+/**
+ * Creates a viewport of the whole map, zoomed out just enough to fit inside the given number of output pixels.
+ *
+ * @param columns The number of output pixels available horizontally.
+ * @param rows The number of output pixels available vertically.
+ * @return A viewport of the whole map.
+ */
+Viewport Topography::fitViewport(int columns, int rows) const {
+    int mapWidth = elevationData[0].size();
+    int mapHeight = elevationData.size();
+
+    Viewport viewport;
+    if (columns > 0) {
+        viewport.zoom = std::max(viewport.zoom, (mapWidth + columns - 1) / columns);
+    }
+    if (rows > 0) {
+        viewport.zoom = std::max(viewport.zoom, (mapHeight + rows - 1) / rows);
+    }
+    return viewport;
+}
+
+/**
+ * Creates empty layers for a viewport, with one value per output pixel. The elevation is set to the lowest possible
+ * value, and there are no markers and no signal influence.
+ *
+ * @param viewport The part of the map the layers cover.
+ * @return The empty layers.
+ */
+Topography::MapLayers Topography::createLayers(const Viewport& viewport) const {
+    Viewport view = clampViewport(viewport);
+    int zoom = view.zoom;
+
+    MapLayers layers;
+    layers.view = view;
+    layers.width = (view.width + zoom - 1) / zoom;
+    layers.height = (view.height + zoom - 1) / zoom;
+    size_t size = static_cast<size_t>(layers.width) * layers.height;
+    layers.elevation.assign(size, std::numeric_limits<int>::min());
+    layers.markers.assign(size, MARKER_NONE);
+    layers.influence.assign(size, 0);
+    return layers;
+}
+
+/**
+ * Marks the output pixels that contain a drone or a part of a connection line. Drones are marked after the lines, so
+ * they are drawn on top.
  *
  * @param nodes Vector of pointers to nodes representing drone positions.
  * @param connectedDrones Vector of pairs of connected drones.
- * @param filename The name of the file to write to.
+ * @param layers The layers to mark.
  */
-void Topography::writeMapToBMP(const std::vector<Node*>& nodes,
-                               const std::vector<std::pair<Node*, Node*>>& connectedDrones,
-                               const std::string& filename) {
-    std::ofstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cout << "Unable to open file: " << filename << std::endl;
-        return;
+void Topography::markLayers(const std::vector<Node*>& nodes,
+                            const std::vector<std::pair<Node*, Node*>>& connectedDrones, MapLayers& layers) {
+    const Viewport& view = layers.view;
+    auto insideView = [&](int x, int y) {
+        return x >= view.x && x < view.x + view.width && y >= view.y && y < view.y + view.height;
+    };
+    auto pooledIndex = [&](int x, int y) {
+        return static_cast<size_t>((y - view.y) / view.zoom) * layers.width + (x - view.x) / view.zoom;
+    };
+
+    for (const auto& connectedDrone : connectedDrones) {
+        for (const auto& point : drawLine(connectedDrone.first, connectedDrone.second)) {
+            if (insideView(point.first, point.second)) {
+                layers.markers[pooledIndex(point.first, point.second)] = MARKER_LINE;
+            }
+        }
+    }
+    for (const auto& node : nodes) {
+        if (insideView(node->getX(), node->getY())) {
+            layers.markers[pooledIndex(node->getX(), node->getY())] = MARKER_DRONE;
+        }
+    }
+}
+
+/**
+ * Downsamples the map layers inside a viewport to one value per output pixel.
+ *
+ * Every output pixel covers a block of zoom x zoom map cells. The elevation of a block is the highest elevation inside
+ * it, and a block is marked as a drone or a connection line if any of its cells is one, so buildings, drones and lines
+ * stay visible when zoomed out. Only map cells inside the viewport are visited. The signal influence is left at 0,
+ * and is filled in by computeInfluence() or computeInfluenceProgressive().
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param connectedDrones Vector of pairs of connected drones.
+ * @param viewport The part of the map to downsample.
+ * @return The downsampled layers in row-major order.
+ */
+Topography::MapLayers Topography::buildMapLayers(const std::vector<Node*>& nodes,
+                                                 const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                                                 const Viewport& viewport) {
+    MapLayers layers = createLayers(viewport);
+    const Viewport& view = layers.view;
+    int zoom = view.zoom;
+
+    // Max pool the elevation
+    for (int y = view.y; y < view.y + view.height; ++y) {
+        const std::vector<int>& row = elevationData[y];
+        int* pooledRow = &layers.elevation[static_cast<size_t>((y - view.y) / zoom) * layers.width];
+        for (int x = view.x; x < view.x + view.width; ++x) {
+            int& pooled = pooledRow[(x - view.x) / zoom];
+            pooled = std::max(pooled, row[x]);
+        }
     }
 
-    int width = elevationData[0].size();
-    int height = elevationData.size();
-    writeBMPHeaders(file, width, height);
+    markLayers(nodes, connectedDrones, layers);
+    return layers;
+}
 
-    int minElevation = elevationData[0][0];
-    int maxElevation = elevationData[0][0];
-    for (const auto& row : elevationData) {
-        for (const auto& elevation : row) {
-            if (elevation < minElevation) {
-                minElevation = elevation;
+/**
+ * Computes the signal influence of an output pixel, at the center cell of the block of map cells it covers.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param layers The layers the pixel belongs to.
+ * @param x x-coordinate of the output pixel.
+ * @param y y-coordinate of the output pixel.
+ * @return The total signal influence of the pixel, or 0 for pixels with a marker.
+ */
+int Topography::getPixelInfluence(const std::vector<Node*>& nodes, const MapLayers& layers, int x, int y) {
+    if (layers.markers[static_cast<size_t>(y) * layers.width + x] != MARKER_NONE) {
+        return 0;
+    }
+    const Viewport& view = layers.view;
+    int blockX = view.x + x * view.zoom;
+    int blockY = view.y + y * view.zoom;
+    int centerX = blockX + std::min(view.zoom, view.x + view.width - blockX) / 2;
+    int centerY = blockY + std::min(view.zoom, view.y + view.height - blockY) / 2;
+    return getTotalDroneInfluence(nodes, centerX, centerY);
+}
+
+/**
+ * Computes the signal influence of every output pixel without a marker.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param layers The layers to fill in.
+ */
+void Topography::computeInfluence(const std::vector<Node*>& nodes, MapLayers& layers) {
+    for (int y = 0; y < layers.height; ++y) {
+        for (int x = 0; x < layers.width; ++x) {
+            layers.influence[static_cast<size_t>(y) * layers.width + x] = getPixelInfluence(nodes, layers, x, y);
+        }
+    }
+}
+
+/**
+ * Checks whether no drone signal can reach a block of output pixels, by comparing the distance from every drone to
+ * the map cells covered by the block with the range of the drone.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param view The viewport of the layers the block belongs to.
+ * @param x x-coordinate of the top left output pixel of the block.
+ * @param y y-coordinate of the top left output pixel of the block.
+ * @param size The width and height of the block in output pixels.
+ * @return true if the influence is 0 everywhere in the block, false if it may not be.
+ */
+bool isOutOfRange(const std::vector<Node*>& nodes, const Viewport& view, int x, int y, int size) {
+    double left = view.x + x * view.zoom;
+    double top = view.y + y * view.zoom;
+    double right = std::min(view.x + (x + size) * view.zoom, view.x + view.width) - 1;
+    double bottom = std::min(view.y + (y + size) * view.zoom, view.y + view.height) - 1;
+    for (const auto& node : nodes) {
+        double range = std::sqrt(node->getSignalPower() / (2.0 * M_PI * 0.2));
+        double dx = std::max({left - node->getX(), 0.0, node->getX() - right});
+        double dy = std::max({top - node->getY(), 0.0, node->getY() - bottom});
+        if (dx * dx + dy * dy <= (range + 1) * (range + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Computes the signal influence of the output pixels from coarse to fine.
+ *
+ * The influence is first sampled on a coarse grid, and every block of the grid is previewed with the sample at its
+ * top left corner. Each pass then halves the blocks, sampling new points only inside blocks whose corner samples
+ * disagree. A block whose samples agree is only filled without further sampling when no drone is in range of it, so
+ * the influence is exactly 0 there, and the result of the last pass is identical to computeInfluence().
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param layers The layers to fill in.
+ * @param onPass Called with the layers after every pass, the last call holds the final result.
+ */
+void Topography::computeInfluenceProgressive(const std::vector<Node*>& nodes, MapLayers& layers,
+                                             const std::function<void(const MapLayers&)>& onPass) {
+    int width = layers.width;
+    int height = layers.height;
+    std::vector<bool> sampled(static_cast<size_t>(width) * height, false);
+
+    auto sample = [&](int x, int y) {
+        size_t index = static_cast<size_t>(y) * width + x;
+        if (!sampled[index]) {
+            layers.influence[index] = getPixelInfluence(nodes, layers, x, y);
+            sampled[index] = true;
+        }
+        return layers.influence[index];
+    };
+    auto fill = [&](int x, int y, int size, int value, bool exact) {
+        for (int blockY = y; blockY < std::min(y + size, height); ++blockY) {
+            for (int blockX = x; blockX < std::min(x + size, width); ++blockX) {
+                size_t index = static_cast<size_t>(blockY) * width + blockX;
+                if (!sampled[index]) {
+                    layers.influence[index] = value;
+                    sampled[index] = exact;
+                }
+            }
+        }
+    };
+
+    int size = 1;
+    while (size * 8 < std::max(width, height) && size < 32) {
+        size *= 2;
+    }
+
+    std::vector<std::pair<int, int>> blocks;
+    for (int y = 0; y < height; y += size) {
+        for (int x = 0; x < width; x += size) {
+            blocks.emplace_back(x, y);
+            fill(x, y, size, sample(x, y), false);
+        }
+    }
+    onPass(layers);
+
+    while (!blocks.empty()) {
+        std::vector<std::pair<int, int>> refined;
+        int half = size / 2;
+        for (const auto& [x, y] : blocks) {
+            if (size == 1) {
+                continue;  // The block is its own sample
+            }
+            int right = std::min(x + size, width - 1);
+            int bottom = std::min(y + size, height - 1);
+            int value = sample(x, y);
+            bool agree = sample(right, y) == value && sample(x, bottom) == value && sample(right, bottom) == value;
+            if (agree && value == 0 && isOutOfRange(nodes, layers.view, x, y, size)) {
+                fill(x, y, size, 0, true);
+                continue;
             }
-            if (elevation > maxElevation) {
-                maxElevation = elevation;
+            for (int subY = y; subY < std::min(y + size, height); subY += half) {
+                for (int subX = x; subX < std::min(x + size, width); subX += half) {
+                    refined.emplace_back(subX, subY);
+                    fill(subX, subY, half, sample(subX, subY), false);
+                }
             }
         }
+        blocks = std::move(refined);
+        size = half;
+        if (!blocks.empty()) {
+            onPass(layers);
+        }
     }
+}
 
-    std::vector<std::vector<bool>> linePoints(height, std::vector<bool>(width, false));
-    for (const auto& connectedDrone : connectedDrones) {
-        auto points = drawLine(connectedDrone.first, connectedDrone.second);
-        for (const auto& point : points) {
-            linePoints[point.second][point.first] = true;
+/**
+ * Writes downsampled map layers as an 8-bit palette BMP image. Grayscale and influence are quantized to the fixed
+ * palette from buildIndexedPalette(), and the pixels are optionally compressed with BI_RLE8, which shrinks the large
+ * flat areas of the map to a few bytes per row.
+ *
+ * @param layers The layers to write.
+ * @param file The stream to write the image to.
+ * @param compress Whether to compress the pixels with BI_RLE8.
+ */
+void Topography::writeLayersToIndexedBMP(const MapLayers& layers, std::ostream& file, bool compress) {
+    static const std::vector<uint8_t> palette = buildIndexedPalette();
+
+    auto start = file.tellp();
+    int width = layers.width;
+    int height = layers.height;
+    writeBMPHeaders(file, width, height, 8, compress ? 1 : 0, PALETTE_SIZE);
+    file.write(reinterpret_cast<const char*>(palette.data()), static_cast<std::streamsize>(palette.size()));
+
+    // Uncompressed rows are padded to a multiple of 4 bytes
+    size_t stride = (static_cast<size_t>(width) + 3) & ~static_cast<size_t>(3);
+    std::vector<uint8_t> row(stride, 0);
+    std::vector<uint8_t> pixels;
+    pixels.reserve(compress ? static_cast<size_t>(height) * 16 : stride * height);
+
+    for (int y = 0; y < height; ++y) {
+        size_t offset = static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x) {
+            uint8_t marker = layers.markers[offset + x];
+            if (marker == MARKER_DRONE) {
+                row[x] = PALETTE_DRONE;
+            } else if (marker == MARKER_LINE) {
+                row[x] = PALETTE_LINE;
+            } else {
+                int grayscale = grayscaleLookup[layers.elevation[offset + x] - minElevation];
+                int influence = std::min(layers.influence[offset + x], 70);
+                int grayscaleLevel = (grayscale * (PALETTE_GRAYSCALE_LEVELS - 1) + 127) / 255;
+                int influenceLevel = (influence * (PALETTE_INFLUENCE_LEVELS - 1) + 35) / 70;
+                row[x] = 2 + influenceLevel * PALETTE_GRAYSCALE_LEVELS + grayscaleLevel;
+            }
+        }
+        if (compress) {
+            encodeRLE8Row(row.data(), width, pixels);
+        } else {
+            pixels.insert(pixels.end(), row.begin(), row.end());
         }
     }
+    if (compress) {
+        pixels.back() = 1;  // The last end of line becomes the end of bitmap marker
+    }
+    file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+
+    auto end = file.tellp();
+    uint32_t imageSize = pixels.size();
+    uint32_t fileSize = end - start;
+    file.seekp(start + std::streamoff(2));
+    file.write(reinterpret_cast<const char*>(&fileSize), 4);
+    file.seekp(start + std::streamoff(34));
+    file.write(reinterpret_cast<const char*>(&imageSize), 4);
+    file.seekp(end);
+}
+
+/**
+ * Shades downsampled map layers into an image. Grayscale values come from the elevation lookup table, or from a
+ * previously shaded terrain image of the same viewport, and the signal influence is blended into one whole row at a
+ * time.
+ *
+ * @param layers The layers to shade.
+ * @param terrain The shaded terrain of the viewport, or nullptr to shade the elevation layer.
+ * @return The shaded image.
+ */
+PixelImage Topography::shadeLayers(const MapLayers& layers, const PixelImage* terrain) {
+    int width = layers.width;
+    int height = layers.height;
+
+    PixelImage image;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(static_cast<size_t>(width) * height * 3);
+    std::vector<uint16_t> grayscaleRow(width);
+    std::vector<uint16_t> influenceRow(width);
+    std::vector<uint8_t> redBlueRow(width);
+    std::vector<uint8_t> greenRow(width);
 
-    // Write pixel data
     for (int y = 0; y < height; ++y) {
+        const int* elevation = &layers.elevation[static_cast<size_t>(y) * width];
+        const int* influence = &layers.influence[static_cast<size_t>(y) * width];
+        const uint8_t* markers = &layers.markers[static_cast<size_t>(y) * width];
         for (int x = 0; x < width; ++x) {
-            int grayscale = getGrayscale(elevationData[y][x], minElevation, maxElevation);
-            int totalInfluence = getTotalDroneInfluence(nodes, x, y);
-            if (isDronePosition(nodes, x, y)) {
-                file.put(0).put(0).put(255);
-            } else if (linePoints[y][x]) {
-                file.put(255).put(0).put(0);
-            } else if (totalInfluence > 0) {
-                writeInfluencedPixel(file, grayscale, totalInfluence);
+            // Every channel of an unmarked terrain pixel holds its grayscale value
+            grayscaleRow[x] = terrain != nullptr ? terrain->pixels[(static_cast<size_t>(y) * width + x) * 3]
+                                                 : grayscaleLookup[elevation[x] - minElevation];
+            influenceRow[x] = static_cast<uint16_t>(influence[x]);
+        }
+        blendInfluenceRow(grayscaleRow.data(), influenceRow.data(), redBlueRow.data(), greenRow.data(), width);
+
+        uint8_t* pixel = &image.pixels[static_cast<size_t>(y) * width * 3];
+        for (int x = 0; x < width; ++x, pixel += 3) {
+            if (markers[x] == MARKER_DRONE) {
+                pixel[0] = 0; pixel[1] = 0; pixel[2] = 255;
+            } else if (markers[x] == MARKER_LINE) {
+                pixel[0] = 255; pixel[1] = 0; pixel[2] = 0;
             } else {
-                writeGrayscalePixel(file, grayscale);
+                pixel[0] = redBlueRow[x]; pixel[1] = greenRow[x]; pixel[2] = redBlueRow[x];
             }
         }
     }
+    return image;
+}
 
-    auto fileSize = file.tellp();
-    file.seekp(2);
+/**
+ * Writes an image as a 24-bit BMP image. The rows are written in the order they are stored.
+ *
+ * @param image The image to write.
+ * @param file The stream to write the image to.
+ */
+void Topography::writeImageToBMP(const PixelImage& image, std::ostream& file) {
+    auto start = file.tellp();
+    writeBMPHeaders(file, image.width, image.height);
+
+    // Every row of pixels is padded to a multiple of 4 bytes
+    size_t rowSize = static_cast<size_t>(image.width) * 3;
+    const char padding[3] = {0, 0, 0};
+    for (int y = 0; y < image.height; ++y) {
+        file.write(reinterpret_cast<const char*>(&image.pixels[rowSize * y]), static_cast<std::streamsize>(rowSize));
+        file.write(padding, static_cast<std::streamsize>((4 - rowSize % 4) % 4));
+    }
+
+    auto end = file.tellp();
+    uint32_t fileSize = end - start;
+    file.seekp(start + std::streamoff(2));
     file.write(reinterpret_cast<const char*>(&fileSize), 4);
+    file.seekp(end);
+}
+
+/**
+ * Writes downsampled map layers as a BMP image.
+ *
+ * @param layers The layers to write.
+ * @param file The stream to write the image to.
+ * @param format The pixel format of the image.
+ */
+void Topography::writeLayersToBMP(const MapLayers& layers, std::ostream& file, BitmapFormat format) {
+    if (format != BitmapFormat::RGB24) {
+        writeLayersToIndexedBMP(layers, file, format == BitmapFormat::RLE8);
+        return;
+    }
+    writeImageToBMP(shadeLayers(layers), file);
+}
+
+/**
+ * Writes downsampled map layers to a BMP image file.
+ *
+ * @param layers The layers to write.
+ * @param filename The name of the file to write to.
+ * @param format The pixel format of the file.
+ */
+void Topography::writeLayersToBMP(const MapLayers& layers, const std::string& filename, BitmapFormat format) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Unable to open file: " << filename << std::endl;
+        return;
+    }
+    writeLayersToBMP(layers, file, format);
     file.close();
 }
 
 /**
- * Prints a topographical map to the console.
+ * Encodes the terrain inside a viewport as a BMP image in memory, without any drones, lines or signal influence.
+ *
+ * @param viewport The part of the map to encode, and how far to zoom out.
+ * @param format The pixel format of the image.
+ * @return The bytes of the BMP image.
+ */
+std::string Topography::encodeTerrainBMP(const Viewport& viewport, BitmapFormat format) {
+    MapLayers layers = buildMapLayers({}, {}, viewport);
+    std::ostringstream image(std::ios::binary);
+    writeLayersToBMP(layers, image, format);
+    return image.str();
+}
+
+/**
+ * Writes a topographical map to a BMP image file.
  *
  * This method visualizes the drone network, including drone positions, signal influences, and drone connections,
- * on a map using ASCII characters. The color of each character is determined by the terrain elevation, the signal
- * influence of drones at the character's position, and whether a drone is present or a drone connection passes
- * through the character's position. The map is printed to the console with ANSI color codes.
+ * on a grayscale map. The color of each pixel is determined by the terrain elevation, the signal influence of
+ * drones at the pixel's position, and whether a drone is present or a drone connection passes through the pixel's position.
  *
  * @param nodes Vector of pointers to nodes representing drone positions.
  * @param connectedDrones Vector of pairs of connected drones.
+ * @param filename The name of the file to write to.
+ * @param viewport The part of the map to write, and how far to zoom out.
+ * @param format The pixel format of the file.
  */
-void Topography::printMapToConsole(const std::vector<Node*>& nodes,
-                                   const std::vector<std::pair<Node*, Node*>>& connectedDrones) {
-    int width = elevationData[0].size();
-    int height = elevationData.size();
+void Topography::writeMapToBMP(const std::vector<Node*>& nodes,
+                               const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                               const std::string& filename, const Viewport& viewport, BitmapFormat format) {
+    MapLayers layers = buildMapLayers(nodes, connectedDrones, viewport);
+    computeInfluence(nodes, layers);
+    writeLayersToBMP(layers, filename, format);
+}
 
-    std::vector<std::vector<bool>> linePoints(height, std::vector<bool>(width, false));
-    for (const auto& connectedDrone : connectedDrones) {
-        auto points = drawLine(connectedDrone.first, connectedDrone.second);
-        for (const auto& point : points) {
-            linePoints[point.second][point.first] = true;
-        }
-    }
+/**
+ * Renders a topographical map into an image in memory, with the same colors as writeMapToBMP().
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param connectedDrones Vector of pairs of connected drones.
+ * @param viewport The part of the map to render, and how far to zoom out.
+ * @return The rendered image.
+ */
+PixelImage Topography::renderMap(const std::vector<Node*>& nodes,
+                                 const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                                 const Viewport& viewport) {
+    MapLayers layers = buildMapLayers(nodes, connectedDrones, viewport);
+    computeInfluence(nodes, layers);
+    return shadeLayers(layers);
+}
 
-    int minElevation = elevationData[0][0];
-    int maxElevation = elevationData[0][0];
-    for (const auto& row : elevationData) {
-        for (const auto& elevation : row) {
-            if (elevation < minElevation) {
-                minElevation = elevation;
+/**
+ * Renders only the terrain of a viewport, without any drones, lines or signal influence. The result can be cached and
+ * passed to compositeMap() to draw the network on top of it.
+ *
+ * @param viewport The part of the map to render, and how far to zoom out.
+ * @return The rendered terrain.
+ */
+PixelImage Topography::renderTerrain(const Viewport& viewport) {
+    return shadeLayers(buildMapLayers({}, {}, viewport));
+}
+
+/**
+ * Computes the signal influence of every output pixel of a viewport, ignoring drones and lines. The result only
+ * depends on the terrain and on the positions and signal power of the nodes, so it can be reused for as long as the
+ * nodes do not move.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param viewport The part of the map to compute the coverage for, and how far to zoom out.
+ * @return The total signal influence of each output pixel in row-major order.
+ */
+std::vector<int> Topography::renderCoverage(const std::vector<Node*>& nodes, const Viewport& viewport) {
+    MapLayers layers = createLayers(viewport);
+    computeInfluence(nodes, layers);
+    return layers.influence;
+}
+
+/**
+ * Draws the network on top of a terrain image from renderTerrain(). The result is identical to renderMap() with the
+ * same arguments, but the elevation is not downsampled again.
+ *
+ * @param terrain The rendered terrain of the viewport.
+ * @param coverage The signal influence of the viewport from renderCoverage().
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param connectedDrones Vector of pairs of connected drones.
+ * @param viewport The part of the map the terrain and coverage were rendered for.
+ * @return The rendered image.
+ */
+PixelImage Topography::compositeMap(const PixelImage& terrain, const std::vector<int>& coverage,
+                                    const std::vector<Node*>& nodes,
+                                    const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                                    const Viewport& viewport) {
+    MapLayers layers = createLayers(viewport);
+    layers.influence = coverage;
+    markLayers(nodes, connectedDrones, layers);
+    return shadeLayers(layers, &terrain);
+}
+
+/**
+ * Writes a topographical map to a BMP image file progressively. A coarse preview of the signal coverage is written
+ * first, and the file is rewritten after every refinement pass. The last version of the file is identical to the one
+ * written by writeMapToBMP().
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param connectedDrones Vector of pairs of connected drones.
+ * @param filename The name of the file to write to.
+ * @param viewport The part of the map to write, and how far to zoom out.
+ * @param format The pixel format of the file.
+ */
+void Topography::writeMapToBMPProgressive(const std::vector<Node*>& nodes,
+                                          const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                                          const std::string& filename, const Viewport& viewport,
+                                          BitmapFormat format) {
+    MapLayers layers = buildMapLayers(nodes, connectedDrones, viewport);
+    computeInfluenceProgressive(nodes, layers, [&](const MapLayers& pass) {
+        writeLayersToBMP(pass, filename, format);
+    });
+}
+
+/**
+ * Computes the color of a map pixel that is neither a drone nor part of a connection line, using the same blend of
+ * grayscale elevation and green signal influence as the bitmap images.
+ *
+ * @param grayscale The grayscale value of the pixel.
+ * @param totalInfluence The total influence at the pixel location.
+ * @return The color of the pixel packed as 0xRRGGBB.
+ */
+uint32_t getInfluencedColor(int grayscale, int totalInfluence) {
+    uint32_t gray = (grayscale * (100 - totalInfluence)) / 100;
+    uint32_t green = (grayscale * (100 - totalInfluence) + totalInfluence * 255) / 100;
+    return (gray << 16) | (green << 8) | gray;
+}
+
+/**
+ * Prints downsampled map layers to the console.
+ *
+ * The frame is built into a single buffer before it is written, and color codes are only emitted where the color
+ * changes. With half blocks enabled, every character cell shows two map rows using the colors of the bitmap images.
+ * A live frame is drawn in place over the previous live frame, and only the cells that changed are redrawn.
+ *
+ * @param layers The layers to print.
+ * @param halfBlocks Whether to pack two map rows into every character cell.
+ * @param live Whether the frame is drawn in place over the previous live frame.
+ */
+void Topography::printLayersToConsole(const MapLayers& layers, bool halfBlocks, bool live) {
+    int width = layers.width;
+    int height = layers.height;
+
+    const uint32_t droneColor = 0xFF0000;
+    const uint32_t lineColor = 0x0000FF;
+    const uint32_t influenceColor = 0x00FF00;
+    const uint32_t defaultColor = ConsoleRenderer::DEFAULT_COLOR;
+
+    std::vector<ConsoleCell> cells;
+    int rows = halfBlocks ? (height + 1) / 2 : height;
+    cells.reserve(static_cast<size_t>(width) * rows);
+
+    if (halfBlocks) {
+        auto getPixelColor = [&](int x, int y) -> uint32_t {
+            int index = y * width + x;
+            if (layers.markers[index] == MARKER_DRONE) {
+                return droneColor;
             }
-            if (elevation > maxElevation) {
-                maxElevation = elevation;
+            if (layers.markers[index] == MARKER_LINE) {
+                return lineColor;
+            }
+            int grayscale = grayscaleLookup[layers.elevation[index] - minElevation];
+            return getInfluencedColor(grayscale, layers.influence[index]);
+        };
+        for (int y = 0; y < height; y += 2) {
+            for (int x = 0; x < width; ++x) {
+                uint32_t bottom = y + 1 < height ? getPixelColor(x, y + 1) : defaultColor;
+                cells.push_back({0, getPixelColor(x, y), bottom});
             }
         }
-    }
-
-    // Influence chars
-    std::string influenceChars = ".:-=+#%@";
-    const int minInfluenceColor = 20;  // Set this to the minimum influence needed to color the character green
-
-    // Write pixel data
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int elevation = elevationData[y][x];
-            if (isDronePosition(nodes, x, y)) {
-                std::cout << "\033[41mD";  // Drone position (red background)
-            } else if (linePoints[y][x]) {
-                std::cout << "\033[44mL";  // Connected drone line (blue background)
-            } else {
-                int totalInfluence = getTotalDroneInfluence(nodes, x, y);
-                if (totalInfluence > 0) {
-                    char influenceChar = influenceChars[totalInfluence / 10];
-                    if (totalInfluence >= minInfluenceColor) {
-                        std::cout << "\033[48;2;0;255;0m" << influenceChar;  // Influence character (green background)
+    } else {
+        // Influence chars
+        std::string influenceChars = ".:-=+#%@";
+        const int minInfluenceColor = 20;  // Set this to the minimum influence needed to color the character green
+
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                int index = y * width + x;
+                int elevation = layers.elevation[index];
+                if (layers.markers[index] == MARKER_DRONE) {
+                    cells.push_back({'D', defaultColor, droneColor});  // Drone position (red background)
+                } else if (layers.markers[index] == MARKER_LINE) {
+                    cells.push_back({'L', defaultColor, lineColor});  // Connected drone line (blue background)
+                } else {
+                    int totalInfluence = layers.influence[index];
+                    if (totalInfluence > 0) {
+                        char influenceChar = influenceChars[totalInfluence / 10];
+                        if (totalInfluence >= minInfluenceColor) {
+                            cells.push_back({influenceChar, defaultColor, influenceColor});  // Green background
+                        } else {
+                            cells.push_back({influenceChar, defaultColor, defaultColor});
+                        }
                     } else {
-                        std::cout << influenceChar;
+                        // Normalize elevation to 0-255 for grayscale
+                        uint32_t normalizedElevation = grayscaleLookup[elevation - minElevation];
+                        uint32_t gray = (normalizedElevation << 16) | (normalizedElevation << 8) | normalizedElevation;
+                        cells.push_back({'O', gray, gray});
                     }
-                } else {
-                    // Normalize elevation to 0-255 for grayscale
-                    int normalizedElevation = 255 - static_cast<int>(((elevation - minElevation) / static_cast<double>(maxElevation - minElevation)) * 255);
-                    std::cout << "\033[38;2;" << normalizedElevation << ";" << normalizedElevation << ";" << normalizedElevation << "m"  // Set foreground color
-                              << "\033[48;2;" << normalizedElevation << ";" << normalizedElevation << ";" << normalizedElevation << "mO";  // Set background color and print character
                 }
             }
         }
-        std::cout << "\033[0m\n";  // Reset color after each line
     }
+
+    consoleRenderer.render(cells, width, rows, live, std::cout);
 }
 
+/**
+ * Prints a topographical map to the console.
+ *
+ * This method visualizes the drone network, including drone positions, signal influences, and drone connections,
+ * on a map using ASCII characters. The color of each character is determined by the terrain elevation, the signal
+ * influence of drones at the character's position, and whether a drone is present or a drone connection passes
+ * through the character's position. The map is printed to the console with ANSI color codes.
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param connectedDrones Vector of pairs of connected drones.
+ * @param halfBlocks Whether to pack two map rows into every character cell.
+ * @param live Whether the frame is part of a live view started with startLiveView().
+ * @param viewport The part of the map to print, and how far to zoom out.
+ */
+void Topography::printMapToConsole(const std::vector<Node*>& nodes,
+                                   const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                                   bool halfBlocks, bool live, const Viewport& viewport) {
+    MapLayers layers = buildMapLayers(nodes, connectedDrones, viewport);
+    computeInfluence(nodes, layers);
+    printLayersToConsole(layers, halfBlocks, live);
+}
 
+/**
+ * Prints a topographical map to the console progressively. The screen is cleared and a coarse preview of the signal
+ * coverage is printed first, then every refinement pass redraws the characters that changed in place. The last frame
+ * is identical to the one printed by printMapToConsole().
+ *
+ * @param nodes Vector of pointers to nodes representing drone positions.
+ * @param connectedDrones Vector of pairs of connected drones.
+ * @param halfBlocks Whether to pack two map rows into every character cell.
+ * @param viewport The part of the map to print, and how far to zoom out.
+ */
+void Topography::printMapToConsoleProgressive(const std::vector<Node*>& nodes,
+                                              const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                                              bool halfBlocks, const Viewport& viewport) {
+    MapLayers layers = buildMapLayers(nodes, connectedDrones, viewport);
+    consoleRenderer.reset();
+    computeInfluenceProgressive(nodes, layers, [&](const MapLayers& pass) {
+        printLayersToConsole(pass, halfBlocks, true);
+    });
+    consoleRenderer.reset();
+}
 
+/**
+ * Switches the console to the alternate screen and hides the cursor, so live frames can be redrawn in place.
+ */
+void Topography::startLiveView() {
+    consoleRenderer.reset();
+    std::cout << "\033[?1049h\033[?25l" << std::flush;
+}
+
+/**
+ * Restores the normal screen and cursor after a live view.
+ */
+void Topography::stopLiveView() {
+    consoleRenderer.reset();
+    std::cout << "\033[0m\033[?25h\033[?1049l" << std::flush;
+}
@@ -1,4 +1,8 @@
+#ifndef TOPOGRAPHY_H
+#define TOPOGRAPHY_H
+
 #include "../node/Node.h"
+#include "../render/ConsoleRenderer.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -6,17 +10,87 @@
 #include <algorithm>
 #include <tuple>
 #include <cmath>
+#include <functional>
+
+// A rectangle of the map to render. A width or height of 0 extends the viewport to the edge of the map. Every output
+// pixel covers zoom x zoom cells of the map.
+struct Viewport {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    int zoom = 1;
+};
+
+// An image in memory, with 3 bytes per pixel in blue, green, red order
+struct PixelImage {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+// Pixel formats of the bitmap images. The 8-bit formats quantize the map to a fixed palette.
+enum class BitmapFormat {
+    RGB24,
+    INDEXED8,
+    RLE8
+};
 
  class Topography {
 
  private:
+     // The layers of a viewport, downsampled to one value per output pixel
+     struct MapLayers {
+         Viewport view;
+         int width;
+         int height;
+         std::vector<int> elevation;
+         std::vector<uint8_t> markers;
+         std::vector<int> influence;
+     };
+
+     static constexpr uint8_t MARKER_NONE = 0;
+     static constexpr uint8_t MARKER_LINE = 1;
+     static constexpr uint8_t MARKER_DRONE = 2;
+
      std::vector<std::vector<int>> elevationData;
+     int minElevation = 0;
+     int maxElevation = 0;
+     std::vector<uint8_t> grayscaleLookup;
+     ConsoleRenderer consoleRenderer;
 
      int getTotalDroneInfluence(const std::vector<Node *> &nodes, int x, int y);
 
+     MapLayers createLayers(const Viewport &viewport) const;
+
+     void markLayers(const std::vector<Node*> &nodes, const std::vector<std::pair<Node *, Node *>> &connectedDrones,
+                     MapLayers &layers);
+
+     MapLayers buildMapLayers(const std::vector<Node*> &nodes, const std::vector<std::pair<Node *, Node *>> &connectedDrones,
+                              const Viewport &viewport);
+
+     int getPixelInfluence(const std::vector<Node*> &nodes, const MapLayers &layers, int x, int y);
+
+     void computeInfluence(const std::vector<Node*> &nodes, MapLayers &layers);
+
+     void computeInfluenceProgressive(const std::vector<Node*> &nodes, MapLayers &layers,
+                                      const std::function<void(const MapLayers&)> &onPass);
+
+     PixelImage shadeLayers(const MapLayers &layers, const PixelImage *terrain = nullptr);
+
+     void writeLayersToBMP(const MapLayers &layers, std::ostream &file, BitmapFormat format);
+
+     void writeLayersToBMP(const MapLayers &layers, const std::string &filename, BitmapFormat format);
+
+     void writeLayersToIndexedBMP(const MapLayers &layers, std::ostream &file, bool compress);
+
+     void printLayersToConsole(const MapLayers &layers, bool halfBlocks, bool live);
+
  public:
 
-     Topography() : elevationData(500, std::vector<int>(500, 0)) {}
+     Topography() {
+         setElevationData(std::vector<std::vector<int>>(500, std::vector<int>(500, 0)));
+     }
 
      void setElevationData(const std::vector<std::vector<int>> &elevationData);
 
@@ -26,7 +100,28 @@
 
      void writeMapToBMP(const std::vector<Node*>& nodes,
                         const std::vector<std::pair<Node*, Node*>>& connectedDrones,
-                        const std::string& filename);
+                        const std::string& filename, const Viewport& viewport = Viewport(),
+                        BitmapFormat format = BitmapFormat::RGB24);
+
+     void writeMapToBMPProgressive(const std::vector<Node*>& nodes,
+                                   const std::vector<std::pair<Node*, Node*>>& connectedDrones,
+                                   const std::string& filename, const Viewport& viewport = Viewport(),
+                        BitmapFormat format = BitmapFormat::RGB24);
+
+     PixelImage renderMap(const std::vector<Node*>& nodes,
+                          const std::vector<std::pair<Node*, Node*>>& connectedDrones, const Viewport& viewport);
+
+     PixelImage renderTerrain(const Viewport& viewport);
+
+     std::vector<int> renderCoverage(const std::vector<Node*>& nodes, const Viewport& viewport);
+
+     PixelImage compositeMap(const PixelImage& terrain, const std::vector<int>& coverage,
+                             const std::vector<Node*>& nodes,
+                             const std::vector<std::pair<Node*, Node*>>& connectedDrones, const Viewport& viewport);
+
+     static void writeImageToBMP(const PixelImage &image, std::ostream &file);
+
+     std::string encodeTerrainBMP(const Viewport &viewport, BitmapFormat format);
 
      std::tuple<int, int, int> findObstruction(int startX, int startY, int startZ, int endX, int endY, int endZ);
 
@@ -43,5 +138,20 @@
 
 
      void
-     printMapToConsole(const std::vector<Node*> &nodes, const std::vector<std::pair<Node *, Node *>> &connectedDrones);
- };
\ No newline at end of file
+     printMapToConsole(const std::vector<Node*> &nodes, const std::vector<std::pair<Node *, Node *>> &connectedDrones,
+                       bool halfBlocks = false, bool live = false, const Viewport &viewport = Viewport());
+
+     void printMapToConsoleProgressive(const std::vector<Node*> &nodes,
+                                       const std::vector<std::pair<Node *, Node *>> &connectedDrones,
+                                       bool halfBlocks = false, const Viewport &viewport = Viewport());
+
+     Viewport clampViewport(const Viewport &viewport) const;
+
+     Viewport fitViewport(int columns, int rows) const;
+
+     void startLiveView();
+
+     void stopLiveView();
+ };
+
+#endif // TOPOGRAPHY_H
\ No newline at end of file